@@ -0,0 +1,343 @@
+#include "engine_stub.hpp"
+#include "shared/types.hpp"
+#include "client/client.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+
+namespace intercept::benchmark {
+    namespace {
+        size_t allocation_count = 0;
+        size_t deallocation_count = 0;
+
+        //Same layout as MemTableFunctions in containers.cpp, which is what the client calls through
+        class stub_allocator {
+        public:
+            virtual void *New(size_t size) { ++allocation_count; return std::malloc(size); }
+            virtual void *New(size_t size, const char *, int) { return New(size); }
+            virtual void Delete(void *mem) { if (mem) ++deallocation_count; std::free(mem); }
+            virtual void Delete(void *mem, const char *, int) { Delete(mem); }
+            virtual void *Realloc(void *mem, size_t size) { ++allocation_count; return std::realloc(mem, size); }
+            virtual void *Realloc(void *mem, size_t size, const char *, int) { return Realloc(mem, size); }
+        };
+
+        stub_allocator allocator;
+        types::__internal::allocatorInfo allocator_info{};
+        types::rv_pool_allocator pool{};
+
+        const types::__internal::allocatorInfo *get_engine_allocator() {
+            return &allocator_info;
+        }
+
+    #ifndef __linux__
+        //Pool functions are __thiscall in the engine, __fastcall has the same register for this and cleans the stack the same way
+        void *__fastcall pool_alloc(types::rv_pool_allocator *, void *, size_t count_) {
+            ++allocation_count;
+            return std::malloc(count_ * 64);
+        }
+        void __fastcall pool_dealloc(types::rv_pool_allocator *, void *, void *data_) {
+            ++deallocation_count;
+            std::free(data_);
+        }
+    #endif
+
+        uintptr_t vtable_of(const void *object_) {
+            return *reinterpret_cast<const uintptr_t *>(object_);
+        }
+
+        const types::sqf_script_type &stub_script_type() {
+            static types::sqf_script_type type;
+            return type;
+        }
+
+        r_string number_to_string(float number_) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%g", number_);
+            return r_string(std::string_view(buffer));
+        }
+
+        //The game_data constructors write the engines vtables (type_def and data_type_def) into the object.
+        //A derived class without data members has the same layout, so its vtables can stand in for the engines,
+        //and its overrides do what the engine implementation would.
+        struct stub_number : types::game_data_number {
+            const types::sqf_script_type &type() const override { return stub_script_type(); }
+            bool get_as_bool() const override { return number != 0.f; }
+            float get_as_number() const override { return number; }
+            game_data *copy() const override { return new game_data_number(*this); }
+            r_string to_string() const override { return number_to_string(number); }
+            bool equals(const game_data *other_) const override {
+                return vtable_of(other_) == vtable_of(this) && static_cast<const game_data_number *>(other_)->number == number;
+            }
+            const char *type_as_string() const override { return "scalar"; }
+        };
+
+        struct stub_bool : types::game_data_bool {
+            const types::sqf_script_type &type() const override { return stub_script_type(); }
+            bool get_as_bool() const override { return val; }
+            game_data *copy() const override { return new game_data_bool(*this); }
+            r_string to_string() const override { return r_string(val ? "true"sv : "false"sv); }
+            bool equals(const game_data *other_) const override {
+                return vtable_of(other_) == vtable_of(this) && static_cast<const game_data_bool *>(other_)->val == val;
+            }
+            const char *type_as_string() const override { return "bool"; }
+        };
+
+        struct stub_array : types::game_data_array {
+            const types::sqf_script_type &type() const override { return stub_script_type(); }
+            const auto_array<game_value> &get_as_const_array() const override { return data; }
+            auto_array<game_value> &get_as_array() override { return data; }
+            game_data *copy() const override { return new game_data_array(*this); }
+            r_string to_string() const override {
+                std::string result = "[";
+                for (auto &element : data) {
+                    if (result.size() > 1) result += ',';
+                    result += element.data ? static_cast<std::string_view>(element.data->to_string()) : "any"sv;
+                }
+                result += ']';
+                return r_string(result);
+            }
+            bool equals(const game_data *other_) const override {
+                if (vtable_of(other_) != vtable_of(this)) return false;
+                auto &other = static_cast<const game_data_array *>(other_)->data;
+                return other.size() == data.size() && std::equal(data.begin(), data.end(), other.begin());
+            }
+            const char *type_as_string() const override { return "array"; }
+        };
+
+        struct stub_string : types::game_data_string {
+            const types::sqf_script_type &type() const override { return stub_script_type(); }
+            const r_string &get_as_string() const override { return raw_string; }
+            game_data *copy() const override { return new game_data_string(*this); }
+            //Quoted like str does it, with quotes inside doubled
+            r_string to_string() const override {
+                std::string result = "\"";
+                for (auto character : static_cast<std::string_view>(raw_string)) {
+                    if (character == '"') result += '"';
+                    result += character;
+                }
+                result += '"';
+                return r_string(result);
+            }
+            bool equals(const game_data *other_) const override {
+                return vtable_of(other_) == vtable_of(this) && static_cast<const game_data_string *>(other_)->raw_string == raw_string;
+            }
+            const char *type_as_string() const override { return "string"; }
+        };
+
+        //game_value and sqf_script_type constructors write their type_def, a derived class gets its own vtable written after them
+        struct game_value_probe : types::game_value {};
+        struct script_type_probe : types::sqf_script_type {};
+
+        struct type_structure {
+            uintptr_t type_def;
+            uintptr_t data_type_def;
+        };
+        std::unordered_map<std::string_view, type_structure> type_structures;
+
+        template <class Type>
+        void install_type(std::string_view name_) {
+            //Never destroyed, the vtables have to stay valid
+            alignas(Type) static unsigned char storage[sizeof(Type)];
+            auto object = ::new (static_cast<void *>(storage)) Type();
+            type_structures[name_] = {vtable_of(object), vtable_of(static_cast<types::__internal::I_debug_value *>(object))};
+        }
+
+        template <class Type>
+        void install_probe(std::string_view name_) {
+            alignas(Type) static unsigned char storage[sizeof(Type)];
+            type_structures[name_] = {vtable_of(::new (static_cast<void *>(storage)) Type()), 0};
+        }
+
+        void get_type_structure(std::string_view type_name_, uintptr_t &type_def_, uintptr_t &data_type_def_) {
+            //Types the stub doesn't implement get no vtable, so type_enum never reports them
+            auto found = type_structures.find(type_name_);
+            type_def_ = found == type_structures.end() ? 0 : found->second.type_def;
+            data_type_def_ = found == type_structures.end() ? 0 : found->second.data_type_def;
+        }
+
+    #pragma region Operators
+        std::unordered_map<std::string, types::nular_function> nular_operators;
+        std::unordered_map<std::string, types::unary_function> unary_operators;
+        std::unordered_map<std::string, types::binary_function> binary_operators;
+
+        std::string lowercase(std::string_view name_) {
+            std::string name(name_);
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char character_) { return static_cast<char>(std::tolower(character_)); });
+            return name;
+        }
+
+        template <typename Function>
+        Function find_operator(const std::unordered_map<std::string, Function> &operators_, std::string_view name_) {
+            auto found = operators_.find(lowercase(name_));
+            return found == operators_.end() ? nullptr : found->second;
+        }
+
+        types::nular_function get_nular_function(std::string_view function_name_) {
+            return find_operator(nular_operators, function_name_);
+        }
+        types::unary_function get_unary_function(std::string_view function_name_) {
+            return find_operator(unary_operators, function_name_);
+        }
+        types::unary_function get_unary_function_typed(std::string_view function_name_, std::string_view) {
+            return find_operator(unary_operators, function_name_);
+        }
+        types::binary_function get_binary_function(std::string_view function_name_) {
+            return find_operator(binary_operators, function_name_);
+        }
+        types::binary_function get_binary_function_typed(std::string_view function_name_, std::string_view, std::string_view) {
+            return find_operator(binary_operators, function_name_);
+        }
+
+        //Same as invoker::invoke_raw_nolock, the stub has no simulation thread to synchronize with
+        game_value invoke_raw_nular(types::nular_function function_) {
+            return function_(stub_game_state());
+        }
+        game_value invoke_raw_unary(types::unary_function function_, const game_value &right_arg_) {
+            return function_(stub_game_state(), right_arg_);
+        }
+        game_value invoke_raw_binary(types::binary_function function_, const game_value &left_arg_, const game_value &right_arg_) {
+            return function_(stub_game_state(), left_arg_, right_arg_);
+        }
+
+        std::recursive_mutex invoker_mutex;
+        void invoker_lock() {
+            invoker_mutex.lock();
+        }
+        void invoker_unlock() {
+            invoker_mutex.unlock();
+        }
+
+        uint32_t get_module_id(std::string_view) {
+            return 0;
+        }
+
+        void register_default_operators() {
+            register_nular("pi"sv, [](game_state &) -> game_value { return 3.14159265f; });
+            register_nular("true"sv, [](game_state &) -> game_value { return true; });
+            register_nular("false"sv, [](game_state &) -> game_value { return false; });
+
+            register_unary("count"sv, [](game_state &, game_value_parameter right_) -> game_value {
+                return static_cast<float>(right_.size());
+            });
+            register_unary("str"sv, [](game_state &, game_value_parameter right_) -> game_value {
+                return right_.data ? right_.data->to_string() : r_string("any"sv);
+            });
+            register_unary("abs"sv, [](game_state &, game_value_parameter right_) -> game_value {
+                return std::fabs(static_cast<float>(right_));
+            });
+
+            register_binary("+"sv, [](game_state &state_, game_value_parameter left_, game_value_parameter right_) -> game_value {
+                const auto type = left_.type_enum();
+                if (type != right_.type_enum()) {
+                    state_.set_script_error(game_state::game_evaluator::evaluator_error_type::type, r_string("Type mismatch"sv));
+                    return {};
+                }
+                switch (type) {
+                    case game_data_type::SCALAR: return static_cast<float>(left_) + static_cast<float>(right_);
+                    case game_data_type::STRING: return static_cast<std::string>(left_) + static_cast<std::string>(right_);
+                    case game_data_type::ARRAY: {
+                        auto_array<game_value> result(left_.to_array());
+                        result.append_range(right_.to_array());
+                        return result;
+                    }
+                    default: return {};
+                }
+            });
+            register_binary("select"sv, [](game_state &, game_value_parameter left_, game_value_parameter right_) -> game_value {
+                auto &array = left_.to_array();
+                const auto index = static_cast<int>(right_);
+                if (index < 0 || static_cast<size_t>(index) >= array.count()) return {};
+                return array[index];
+            });
+            register_binary("pushback"sv, [](game_state &, game_value_parameter left_, game_value_parameter right_) -> game_value {
+                auto &array = left_.to_array();
+                array.push_back(right_);
+                return static_cast<float>(array.count() - 1);
+            });
+            register_binary("isequalto"sv, [](game_state &, game_value_parameter left_, game_value_parameter right_) -> game_value {
+                return left_ == right_;
+            });
+        }
+    #pragma endregion
+    }  // namespace
+
+    void install_engine_stub() {
+    #ifdef __linux__
+        //On Linux the engine allocator object is embedded at genericAllocBase
+        std::memcpy(&allocator_info.genericAllocBase, &allocator, sizeof(uintptr_t));
+    #else
+        allocator_info.genericAllocBase = reinterpret_cast<uintptr_t>(&allocator);
+        allocator_info.poolFuncAlloc = reinterpret_cast<uintptr_t>(&pool_alloc);
+        allocator_info.poolFuncDealloc = reinterpret_cast<uintptr_t>(&pool_dealloc);
+    #endif
+        allocator_info._poolAllocs.fill(&pool);
+        allocator_info.gameState = &stub_game_state();
+
+        install_type<stub_number>("SCALAR"sv);
+        install_type<stub_bool>("BOOL"sv);
+        install_type<stub_array>("ARRAY"sv);
+        install_type<stub_string>("STRING"sv);
+        install_probe<game_value_probe>("GV"sv);
+        install_probe<script_type_probe>("SQF_SCRIPT_TYPE"sv);
+        register_default_operators();
+
+        client_functions functions{};
+        functions.invoke_raw_nular = &invoke_raw_nular;
+        functions.invoke_raw_nular_nolock = &invoke_raw_nular;
+        functions.invoke_raw_unary = &invoke_raw_unary;
+        functions.invoke_raw_unary_nolock = &invoke_raw_unary;
+        functions.invoke_raw_binary = &invoke_raw_binary;
+        functions.invoke_raw_binary_nolock = &invoke_raw_binary;
+        functions.get_type_structure = &get_type_structure;
+        functions.get_nular_function = &get_nular_function;
+        functions.get_unary_function = &get_unary_function;
+        functions.get_unary_function_typed = &get_unary_function_typed;
+        functions.get_binary_function = &get_binary_function;
+        functions.get_binary_function_typed = &get_binary_function_typed;
+        functions.invoker_lock = &invoker_lock;
+        functions.invoker_unlock = &invoker_unlock;
+        functions.get_engine_allocator = &get_engine_allocator;
+        //Goes through the same initialization a plugin gets from the host, the module name already needs the allocator
+        client::host::functions.get_engine_allocator = &get_engine_allocator;
+        client::assign_functions(functions, r_string("engine_stub"sv));
+        client_functions_v3 functions_v3{};
+        functions_v3.get_module_id = &get_module_id;
+        client::assign_functions_v3(&functions_v3, r_string("engine_stub"sv));
+
+        allocation_count = 0;
+        deallocation_count = 0;
+    }
+
+    size_t engine_allocations() {
+        return allocation_count;
+    }
+
+    size_t engine_deallocations() {
+        return deallocation_count;
+    }
+
+    void register_nular(std::string_view name_, types::nular_function function_) {
+        nular_operators[lowercase(name_)] = function_;
+    }
+
+    void register_unary(std::string_view name_, types::unary_function function_) {
+        unary_operators[lowercase(name_)] = function_;
+    }
+
+    void register_binary(std::string_view name_, types::binary_function function_) {
+        binary_operators[lowercase(name_)] = function_;
+    }
+
+    types::game_state &stub_game_state() {
+        //Value initialized, so it has no evaluator and set_script_error does nothing
+        static types::game_state state{};
+        return state;
+    }
+}  // namespace intercept::benchmark
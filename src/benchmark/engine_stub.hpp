@@ -0,0 +1,44 @@
+/*!
+@file
+@brief Minimal stand-in for the engine so client types can be used outside of the game.
+
+Hands the client a client_functions table through assign_functions, the same
+way the host does. Behind it sit a counting allocator, working vtables for the
+SCALAR, BOOL, ARRAY and STRING game_data types, and a small set of nular,
+unary and binary operators that are invoked on a stand-in game_state. Other
+types and SQF commands are not available.
+*/
+#pragma once
+#include "shared/types.hpp"
+#include <cstddef>
+#include <string_view>
+
+namespace intercept::benchmark {
+    /*!
+    @brief Sets up the allocator, type vtables and operators, call once before creating any game_value.
+    */
+    void install_engine_stub();
+
+    /*!@{
+    @brief Number of engine allocations and deallocations since the stub was installed.
+    */
+    size_t engine_allocations();
+    size_t engine_deallocations();
+    //!@}
+
+    /*!@{
+    @brief Makes an operator available through get_*_function and invoke_raw_*.
+    @details Names are case insensitive like in SQF. Operators are looked up by name only, the _typed lookups ignore
+    the argument types, so registering a name again replaces the previous operator.
+    install_engine_stub registers pi, true and false, count, str and abs, and +, select, pushback and isequalto.
+    */
+    void register_nular(std::string_view name_, types::nular_function function_);
+    void register_unary(std::string_view name_, types::unary_function function_);
+    void register_binary(std::string_view name_, types::binary_function function_);
+    //!@}
+
+    /*!
+    @brief The game_state that operators are invoked on, it has no evaluator, namespaces or script types.
+    */
+    types::game_state& stub_game_state();
+}  // namespace intercept::benchmark
@@ -0,0 +1,130 @@
+/*!
+@file
+@brief Parses and dispatches callExtension input the old way and through arguments and command_table.
+
+The old path is kept here as it was: split into strings, trim each, convert
+numbers with a stream and look the command up in an unordered_map. Both paths
+run the same mix of the calls the game makes every frame.
+*/
+#include "dispatch.hpp"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    std::atomic<uint64_t> allocations{0};
+}
+
+//Counts every allocation of intercept_host_bench, the benchmarks report the ones made while they ran
+void* operator new(size_t size_) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto memory = std::malloc(size_ ? size_ : 1)) return memory;
+    throw std::bad_alloc();
+}
+void operator delete(void* memory_) noexcept { std::free(memory_); }
+void operator delete(void* memory_, size_t) noexcept { std::free(memory_); }
+
+using namespace std::literals;
+
+namespace {
+    const char* const inputs[] = {
+        "fetch_result:",
+        "invoker_set_budget:2000, 8000",
+        "ready:",
+        "set_position: 1.5, 2.25, -3.0",
+        "fetch_result:",
+        "invoker_metrics:reset",
+    };
+
+    float sink = 0.f;
+
+    std::string_view command_of(std::string_view input_) {
+        return input_.substr(0, input_.find(':'));
+    }
+
+    std::string_view arguments_of(std::string_view input_, std::string_view command_) {
+        return input_.length() > command_.length() + 1 ? input_.substr(command_.length() + 1) : std::string_view();
+    }
+
+    namespace old_path {
+        struct arguments {
+            explicit arguments(const std::string& str_) {
+                std::stringstream ss(str_);
+                std::string item;
+                while (std::getline(ss, item, ',')) {
+                    item.erase(item.begin(), std::find_if(item.begin(), item.end(), [](char c) { return !std::isspace(c); }));
+                    item.erase(std::find_if(item.rbegin(), item.rend(), [](char c) { return !std::isspace(c); }).base(), item.end());
+                    args.push_back(item);
+                }
+            }
+            float as_float(size_t index_) const { float res = 0.0f; std::istringstream iss(args[index_]); iss >> res; return res; }
+            int as_int(size_t index_) const { return atoi(args[index_].c_str()); }
+            std::vector<std::string> args;
+        };
+
+        std::unordered_map<std::string_view, std::function<bool(arguments&, std::string&)>> methods;
+
+        void call(std::string_view input_) {
+            const auto command = command_of(input_);
+            std::string argument_str(arguments_of(input_, command));
+            arguments args(argument_str);
+            std::string result = "-1";
+            auto method = methods.find(command);
+            if (method != methods.end()) method->second(args, result);
+        }
+    }  // namespace old_path
+
+    namespace new_path {
+        intercept::dispatcher dispatcher;
+
+        void call(std::string_view input_) {
+            const auto command = command_of(input_);
+            intercept::arguments args(arguments_of(input_, command));
+            std::string result = "-1";
+            dispatcher.call(command, args, result);
+        }
+    }  // namespace new_path
+
+    //Same handlers for both, they only touch their arguments like the real ones do
+    void add_handlers() {
+        if (!old_path::methods.empty()) return;
+        old_path::methods["fetch_result"sv] = [](old_path::arguments&, std::string& result_) { result_.clear(); return true; };
+        old_path::methods["ready"sv] = [](old_path::arguments&, std::string& result_) { result_ = "0"; return true; };
+        old_path::methods["invoker_set_budget"sv] = [](old_path::arguments& args_, std::string&) { sink += static_cast<float>(args_.as_int(0) + args_.as_int(1)); return true; };
+        old_path::methods["set_position"sv] = [](old_path::arguments& args_, std::string&) { sink += args_.as_float(0) + args_.as_float(1) + args_.as_float(2); return true; };
+        old_path::methods["invoker_metrics"sv] = [](old_path::arguments& args_, std::string&) { sink += args_.args[0] == "reset"sv; return true; };
+
+        new_path::dispatcher.add("fetch_result"sv, [](intercept::arguments&, std::string& result_) { result_.clear(); return true; });
+        new_path::dispatcher.add("ready"sv, [](intercept::arguments&, std::string& result_) { result_ = "0"; return true; });
+        new_path::dispatcher.add("invoker_set_budget"sv, [](intercept::arguments& args_, std::string&) { sink += static_cast<float>(args_.as_int(0) + args_.as_int(1)); return true; });
+        new_path::dispatcher.add("set_position"sv, [](intercept::arguments& args_, std::string&) { sink += args_.as_float(0) + args_.as_float(1) + args_.as_float(2); return true; });
+        new_path::dispatcher.add("invoker_metrics"sv, [](intercept::arguments& args_, std::string&) { sink += args_.as_string(0) == "reset"sv; return true; });
+    }
+
+    template <typename Call>
+    void dispatch(::benchmark::State& state_, Call&& call_) {
+        add_handlers();
+        size_t next = 0;
+        const auto allocations_before = allocations.load();
+        for (auto _ : state_)
+            call_(inputs[next++ % std::size(inputs)]);
+        state_.counters["allocations"] = ::benchmark::Counter(static_cast<double>(allocations.load() - allocations_before), ::benchmark::Counter::kAvgIterations);
+        ::benchmark::DoNotOptimize(sink);
+    }
+
+    void dispatch_split_stream_unordered_map(::benchmark::State& state_) {
+        dispatch(state_, old_path::call);
+    }
+    BENCHMARK(dispatch_split_stream_unordered_map);
+
+    void dispatch_arguments_command_table(::benchmark::State& state_) {
+        dispatch(state_, new_path::call);
+    }
+    BENCHMARK(dispatch_arguments_command_table);
+}  // namespace
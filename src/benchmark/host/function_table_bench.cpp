@@ -0,0 +1,98 @@
+/*!
+@file
+@brief Resolves every function in sqf_assignments.hpp through the old overload scan and through function_table.
+*/
+#include "function_table.hpp"
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <regex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace intercept;
+
+namespace {
+    using function = void (*)();
+
+    struct lookup {
+        std::string name;
+        std::string left;
+        std::string right;
+    };
+
+    //What loader::get_function did: map lookup by name, then build the type set of every overload
+    struct overload {
+        std::string left;
+        std::string right;
+        function procedure;
+        std::set<std::string> left_types() const { return {left}; }
+        std::set<std::string> right_types() const { return {right}; }
+    };
+
+    function old_find(const std::unordered_map<std::string, std::vector<overload>>& map_, std::string_view name_, std::string_view left_, std::string_view right_) {
+        auto it = map_.find(std::string(name_));
+        if (it == map_.end()) return nullptr;
+        for (auto& op : it->second) {
+            if ((left_.empty() || op.left_types().count(std::string(left_))) && op.right_types().count(std::string(right_)))
+                return op.procedure;
+        }
+        return nullptr;
+    }
+
+    void dummy_function() {}
+
+    //Every get_*_function call in sqf_assignments.hpp, empty if the file can't be read
+    const std::vector<lookup>& lookups() {
+        static const auto lookups = []() {
+            //host::functions.get_binary_function_typed("action"sv, "OBJECT"sv, "ARRAY"sv);
+            const std::regex call(R"re(get_(nular|unary|binary)_function(?:_typed)?\("([^"]*)"sv(?:, "([^"]*)"sv)?(?:, "([^"]*)"sv)?\))re");
+            std::vector<lookup> lookups;
+            std::ifstream file(INTERCEPT_SQF_ASSIGNMENTS);
+            std::string line;
+            while (std::getline(file, line)) {
+                std::smatch match;
+                if (!std::regex_search(line, match, call)) continue;
+                if (match[1] == "binary")
+                    lookups.push_back({match[2], match[3], match[4]});
+                else
+                    lookups.push_back({match[2], {}, match[3]});
+            }
+            return lookups;
+        }();
+        return lookups;
+    }
+
+    //One iteration resolves every function once
+    template <typename Find>
+    void resolve_all(::benchmark::State& state_, Find&& find_) {
+        auto& entries = lookups();
+        if (entries.empty()) {
+            state_.SkipWithError("can't read " INTERCEPT_SQF_ASSIGNMENTS);
+            return;
+        }
+        size_t found = 0;
+        for (auto _ : state_) {
+            found = 0;
+            for (auto& entry : entries)
+                found += find_(entry) != nullptr;
+        }
+        if (found != entries.size()) state_.SkipWithError("not every function was resolved");
+        state_.SetItemsProcessed(state_.iterations() * entries.size());
+    }
+
+    void function_table_overload_scan(::benchmark::State& state_) {
+        std::unordered_map<std::string, std::vector<overload>> map;
+        for (auto& entry : lookups()) map[entry.name].push_back({entry.left, entry.right, &dummy_function});
+        resolve_all(state_, [&](const lookup& entry_) { return old_find(map, entry_.name, entry_.left, entry_.right); });
+    }
+    BENCHMARK(function_table_overload_scan)->Unit(::benchmark::kMicrosecond);
+
+    void function_table_find(::benchmark::State& state_) {
+        function_table<function> table;
+        for (auto& entry : lookups()) table.insert(entry.name, entry.left, entry.right, &dummy_function);
+        resolve_all(state_, [&](const lookup& entry_) { return table.find(entry_.name, entry_.left, entry_.right); });
+    }
+    BENCHMARK(function_table_find)->Unit(::benchmark::kMicrosecond);
+}  // namespace
@@ -0,0 +1,85 @@
+/*!
+@file
+@brief The loader's old byte by byte search against pattern_scanner on a synthetic 40MB image.
+*/
+#include "pattern_scanner.hpp"
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace intercept;
+
+namespace {
+    constexpr size_t image_size = 40 * 1024 * 1024;
+    constexpr size_t placed_at = image_size - 4096;
+
+    //Same shape as the allocator pattern the loader searches for
+    const char pattern[] = "\x48\x8B\x05\x00\x00\x00\x00\x48\x8B\x0D\x00\x00\x00\x00\x48\x89\x44\x24\x00\xE8";
+    const char mask[] = "xxx????xxx????xxxx?x";
+
+    //Code-like filler, biased towards the bytes that are common in x86 code, with the pattern near the end
+    const std::vector<uint8_t>& image() {
+        static const auto image = []() {
+            std::vector<uint8_t> image(image_size);
+            std::mt19937 rng(1337);
+            const uint8_t common[] = {0x00, 0x00, 0x00, 0xFF, 0x8B, 0x48, 0x89, 0x24, 0x44, 0x4C, 0x85, 0xC0, 0x83, 0xE8, 0x0F, 0xCC};
+            for (auto& byte : image)
+                byte = (rng() & 3) ? common[rng() % sizeof(common)] : static_cast<uint8_t>(rng());
+            memcpy(image.data() + placed_at, pattern, sizeof(pattern) - 1);
+            return image;
+        }();
+        return image;
+    }
+
+    memory::region image_region() {
+        return {reinterpret_cast<uintptr_t>(image().data()), image().size()};
+    }
+
+    //The search loop loader::do_function_walk used before pattern_scanner
+    uintptr_t naive_find(const memory::region& region_, const char* pattern_, const char* mask_) {
+        const uintptr_t pattern_length = strlen(mask_);
+        for (uintptr_t i = 0; i < region_.size - pattern_length; i++) {
+            bool found = true;
+            for (uintptr_t j = 0; j < pattern_length; j++) {
+                found &= mask_[j] == '?' || pattern_[j] == *reinterpret_cast<char*>(region_.base + i + j);
+                if (!found)
+                    break;
+            }
+            if (found)
+                return region_.base + i;
+        }
+        return 0;
+    }
+
+    template <typename Find>
+    void search(::benchmark::State& state_, const memory::region& region_, Find&& find_) {
+        uintptr_t result = 0;
+        for (auto _ : state_) {
+            result = find_();
+            ::benchmark::DoNotOptimize(result);
+        }
+        if (result != region_.base + placed_at) state_.SkipWithError("pattern not found at the expected address");
+        state_.SetBytesProcessed(state_.iterations() * static_cast<int64_t>(placed_at));
+    }
+
+    void scanner_naive_loop(::benchmark::State& state_) {
+        const auto region = image_region();
+        search(state_, region, [&]() { return naive_find(region, pattern, mask); });
+    }
+    BENCHMARK(scanner_naive_loop)->Unit(::benchmark::kMillisecond);
+
+    void scanner_pattern_scanner_single_thread(::benchmark::State& state_) {
+        const auto region = image_region();
+        const memory::pattern_scanner scanner({region}, 1);
+        search(state_, region, [&]() { return scanner.find_pattern(pattern, mask); });
+    }
+    BENCHMARK(scanner_pattern_scanner_single_thread)->Unit(::benchmark::kMillisecond);
+
+    void scanner_pattern_scanner_threaded(::benchmark::State& state_) {
+        const auto region = image_region();
+        const memory::pattern_scanner scanner({region});
+        search(state_, region, [&]() { return scanner.find_pattern(pattern, mask); });
+    }
+    BENCHMARK(scanner_pattern_scanner_threaded)->Unit(::benchmark::kMillisecond)->UseRealTime();
+}  // namespace
@@ -0,0 +1,25 @@
+/*!
+@file
+@brief Reports the engine allocations made during a benchmark as a per iteration counter.
+*/
+#pragma once
+#include "engine_stub.hpp"
+#include <benchmark/benchmark.h>
+
+namespace intercept::benchmark {
+    /*!
+    @brief Counts engine allocations from construction until report.
+    @details Create it right before the timed loop, report adds an "allocations" counter averaged over the iterations.
+    */
+    class allocation_counter {
+    public:
+        allocation_counter() : _before(engine_allocations()) {}
+
+        void report(::benchmark::State &state_) const {
+            state_.counters["allocations"] = ::benchmark::Counter(static_cast<double>(engine_allocations() - _before), ::benchmark::Counter::kAvgIterations);
+        }
+
+    private:
+        size_t _before;
+    };
+}  // namespace intercept::benchmark
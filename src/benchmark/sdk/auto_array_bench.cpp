@@ -0,0 +1,131 @@
+/*!
+@file
+@brief auto_array<game_value> push_back, insert and erase, and growth with each growth policy.
+*/
+#include "allocation_counter.hpp"
+#include "shared/types.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace intercept::types;
+using intercept::benchmark::allocation_counter;
+
+namespace {
+    using linear_array = auto_array<game_value, rv_allocator<game_value>, 32, auto_array_linear_growth>;
+    using growth_1_5x_array = auto_array<game_value, rv_allocator<game_value>, 32, auto_array_growth_1_5x>;
+    using growth_2x_array = auto_array<game_value, rv_allocator<game_value>, 32, auto_array_growth_2x>;
+
+    auto_array<game_value> make_array(int64_t count_) {
+        auto_array<game_value> array;
+        array.reserve(static_cast<size_t>(count_));
+        for (int64_t i = 0; i < count_; ++i) array.emplace_back(static_cast<float>(i));
+        return array;
+    }
+
+    void auto_array_push_back(::benchmark::State &state_) {
+        const game_value value(1.f);
+        for (auto _ : state_) {
+            auto_array<game_value> array;
+            for (int64_t i = 0; i < state_.range(0); ++i) array.push_back(value);
+            ::benchmark::DoNotOptimize(array.data());
+        }
+        state_.SetItemsProcessed(state_.iterations() * state_.range(0));
+    }
+    BENCHMARK(auto_array_push_back)->Range(16, 16 << 10);
+
+    void auto_array_insert_front(::benchmark::State &state_) {
+        const game_value value(1.f);
+        for (auto _ : state_) {
+            auto_array<game_value> array;
+            for (int64_t i = 0; i < state_.range(0); ++i) array.insert(array.begin(), value);
+            ::benchmark::DoNotOptimize(array.data());
+        }
+        state_.SetItemsProcessed(state_.iterations() * state_.range(0));
+    }
+    BENCHMARK(auto_array_insert_front)->Range(16, 1 << 10);
+
+    void auto_array_erase_front(::benchmark::State &state_) {
+        for (auto _ : state_) {
+            state_.PauseTiming();
+            auto array = make_array(state_.range(0));
+            state_.ResumeTiming();
+            while (!array.empty()) array.erase(array.begin());
+        }
+        state_.SetItemsProcessed(state_.iterations() * state_.range(0));
+    }
+    BENCHMARK(auto_array_erase_front)->Range(16, 4 << 10);
+
+    void auto_array_erase_range(::benchmark::State &state_) {
+        for (auto _ : state_) {
+            state_.PauseTiming();
+            auto array = make_array(state_.range(0));
+            state_.ResumeTiming();
+            //Removes the middle half in one go
+            const auto quarter = array.count() / 4;
+            array.erase(array.begin() + quarter, array.end() - quarter);
+            ::benchmark::DoNotOptimize(array.data());
+        }
+        state_.SetItemsProcessed(state_.iterations() * state_.range(0));
+    }
+    BENCHMARK(auto_array_erase_range)->Range(16, 16 << 10);
+
+    //Copies are made with the growth policy of the copied array type
+    template <typename Array>
+    void auto_array_copy(::benchmark::State &state_) {
+        Array source;
+        for (int64_t i = 0; i < state_.range(0); ++i) source.emplace_back(static_cast<float>(i));
+        for (auto _ : state_) {
+            Array copy = source;
+            Array moved = std::move(copy);
+            ::benchmark::DoNotOptimize(moved.data());
+        }
+        state_.SetItemsProcessed(state_.iterations() * state_.range(0));
+    }
+    BENCHMARK_TEMPLATE(auto_array_copy, auto_array<game_value>)->Range(16, 16 << 10);
+    BENCHMARK_TEMPLATE(auto_array_copy, growth_2x_array)->Range(16, 16 << 10);
+    BENCHMARK_TEMPLATE(auto_array_copy, linear_array)->Range(16, 16 << 10);
+
+    //How plugins build results: positions or objects are appended one by one, then handed to the engine
+    template <typename Array>
+    void auto_array_growth(::benchmark::State &state_) {
+        const game_value value(1.f);
+        allocation_counter allocations;
+        for (auto _ : state_) {
+            Array array;
+            for (int64_t i = 0; i < state_.range(0); ++i) array.push_back(value);
+            ::benchmark::DoNotOptimize(array.data());
+        }
+        allocations.report(state_);
+        state_.SetItemsProcessed(state_.iterations() * state_.range(0));
+    }
+    BENCHMARK_TEMPLATE(auto_array_growth, linear_array)->Arg(1000)->Arg(100000);
+    BENCHMARK_TEMPLATE(auto_array_growth, growth_1_5x_array)->Arg(1000)->Arg(100000);
+    BENCHMARK_TEMPLATE(auto_array_growth, growth_2x_array)->Arg(1000)->Arg(100000);
+
+    void auto_array_reserve_push_back(::benchmark::State &state_) {
+        const game_value value(1.f);
+        allocation_counter allocations;
+        for (auto _ : state_) {
+            auto_array<game_value> array;
+            array.reserve(static_cast<size_t>(state_.range(0)));
+            for (int64_t i = 0; i < state_.range(0); ++i) array.push_back(value);
+            ::benchmark::DoNotOptimize(array.data());
+        }
+        allocations.report(state_);
+        state_.SetItemsProcessed(state_.iterations() * state_.range(0));
+    }
+    BENCHMARK(auto_array_reserve_push_back)->Arg(1000)->Arg(100000);
+
+    void auto_array_append_range(::benchmark::State &state_) {
+        const std::vector<game_value> source(static_cast<size_t>(state_.range(0)), game_value(1.f));
+        allocation_counter allocations;
+        for (auto _ : state_) {
+            auto_array<game_value> array;
+            array.append_range(source);
+            ::benchmark::DoNotOptimize(array.data());
+        }
+        allocations.report(state_);
+        state_.SetItemsProcessed(state_.iterations() * state_.range(0));
+    }
+    BENCHMARK(auto_array_append_range)->Arg(1000)->Arg(100000);
+}  // namespace
@@ -0,0 +1,89 @@
+/*!
+@file
+@brief Building SQF arguments with initializer lists and push_back against game_value_builder.
+*/
+#include "allocation_counter.hpp"
+#include "shared/client_types.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace intercept::types;
+using intercept::benchmark::allocation_counter;
+
+namespace {
+    //Stands in for the engine command, reads the arguments like a command would
+    float consume(const game_value &args_) {
+        float sum = 0.f;
+        for (auto &element : args_.to_array()) {
+            if (element.type_enum() == game_data_type::SCALAR) sum += static_cast<float>(element);
+            else if (element.type_enum() == game_data_type::ARRAY) sum += static_cast<float>(element.to_array()[0]);
+        }
+        return sum;
+    }
+
+    //Shape of line_intersects_surfaces [begin, end]
+    void builder_two_positions_initializer_list(::benchmark::State &state_) {
+        float i = 0.f;
+        allocation_counter allocations;
+        for (auto _ : state_) {
+            game_value args({vector3(i, 1.f, 2.f), vector3(3.f, i, 5.f)});
+            ::benchmark::DoNotOptimize(consume(args));
+            ++i;
+        }
+        allocations.report(state_);
+    }
+    BENCHMARK(builder_two_positions_initializer_list);
+
+    void builder_two_positions_builder(::benchmark::State &state_) {
+        game_value_builder args(2);
+        float i = 0.f;
+        allocation_counter allocations;
+        for (auto _ : state_) {
+            args.begin().add(vector3(i, 1.f, 2.f)).add(vector3(3.f, i, 5.f));
+            ::benchmark::DoNotOptimize(consume(args.get()));
+            ++i;
+        }
+        allocations.report(state_);
+    }
+    BENCHMARK(builder_two_positions_builder);
+
+    //Shape of targets [enemyOnly, maxDistance, sides, maxAge, center]
+    void builder_targets_push_back(::benchmark::State &state_) {
+        float i = 0.f;
+        allocation_counter allocations;
+        for (auto _ : state_) {
+            auto_array<game_value> args;
+            args.push_back(true);
+            args.push_back(i);
+            args.push_back(game_value());
+            args.push_back(10.f);
+            args.push_back(vector3(i, 0.f, 0.f));
+            ::benchmark::DoNotOptimize(consume(game_value(std::move(args))));
+            ++i;
+        }
+        allocations.report(state_);
+    }
+    BENCHMARK(builder_targets_push_back);
+
+    void builder_targets_builder(::benchmark::State &state_) {
+        //Keeping a reference to the result must not let the next build modify it
+        game_value_builder builder;
+        builder.begin().add(1.f);
+        const game_value kept = builder.get();
+        builder.begin().add(2.f);
+        if (static_cast<float>(kept.to_array()[0]) != 1.f || static_cast<float>(builder.get().to_array()[0]) != 2.f) {
+            state_.SkipWithError("builder modified a value that was still referenced");
+            return;
+        }
+
+        game_value_builder args(5);
+        float i = 0.f;
+        allocation_counter allocations;
+        for (auto _ : state_) {
+            args.begin().add(true).add(i).add_nil().add(10.f).add(vector3(i, 0.f, 0.f));
+            ::benchmark::DoNotOptimize(consume(args.get()));
+            ++i;
+        }
+        allocations.report(state_);
+    }
+    BENCHMARK(builder_targets_builder);
+}  // namespace
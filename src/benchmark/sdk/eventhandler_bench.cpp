@@ -0,0 +1,120 @@
+/*!
+@file
+@brief Routes InterceptClientEvent calls to their module by name scan and by module id.
+
+Mirrors eventhandlers::client_eventhandler: the forwarder arguments are built
+like the SQF commands the client registers, then one frame of 10k events is
+dispatched to 20 loaded modules per iteration.
+*/
+#include "shared/types.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace intercept::types;
+
+namespace {
+    constexpr size_t module_count = 20;
+    constexpr size_t events_per_frame = 10000;
+
+    int handled = 0;
+
+    //Stands in for the plugins exported client_eventhandler
+    void handler(game_value &ret_, uint8_t, int32_t uid_, int, game_value) {
+        handled += uid_ & 1;
+        ret_ = game_value();
+    }
+
+    struct fake_module {
+        std::string name;
+        uint32_t id;
+        void (*client_eventhandler)(game_value &, uint8_t, int32_t, int, game_value);
+    };
+
+    struct loaded_modules {
+        std::unordered_map<std::string, fake_module> by_name;
+        std::vector<fake_module *> by_id;
+
+        loaded_modules() : by_id(module_count) {
+            for (uint32_t i = 0; i < module_count; ++i) {
+                auto name = "intercept_plugin_" + std::to_string(i);
+                auto &module = by_name[name] = fake_module{name, i, &handler};
+                by_id[i] = &module;
+            }
+        }
+    };
+
+    using frame = std::vector<std::pair<game_value, game_value>>;
+
+    //Same events for both routings, spread evenly over the modules. The first argument is the module name or id
+    frame make_frame(bool by_id_) {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<uint32_t> pick_module(0, module_count - 1);
+        frame events;
+        events.reserve(events_per_frame);
+        for (size_t i = 0; i < events_per_frame; ++i) {
+            const auto id = pick_module(rng);
+            const auto uid = static_cast<float>(rng() & 0xFFFF);
+            game_value this_args({game_value(), 1.f, 2.f});
+            if (by_id_)
+                events.emplace_back(game_value({static_cast<float>(id), 1.f, uid, 0.f}), game_value({this_args}));
+            else
+                events.emplace_back(game_value({"intercept_plugin_" + std::to_string(id), 1.f, uid, 0.f}), game_value({this_args}));
+        }
+        return events;
+    }
+
+    //Old routing: compare the name against every loaded module
+    game_value by_name(std::unordered_map<std::string, fake_module> &modules_, const game_value &left_, const game_value &right_) {
+        auto &args = left_.to_array();
+        const r_string module_name = args[0];
+        for (auto &module : modules_) {
+            if (module.second.client_eventhandler && module.second.name == static_cast<std::string_view>(module_name)) {
+                game_value ret{};
+                module.second.client_eventhandler(ret, static_cast<uint8_t>(static_cast<int>(args[1])), static_cast<int32_t>(static_cast<float>(args[2])), static_cast<int>(args[3]), right_.to_array()[0]);
+                return ret;
+            }
+        }
+        return {};
+    }
+
+    //New routing: the first argument is the module id
+    game_value by_id(const std::vector<fake_module *> &modules_by_id_, const game_value &left_, const game_value &right_) {
+        auto &args = left_.to_array();
+        fake_module *target = nullptr;
+        if (args[0].type() == game_data_number::type_def) {
+            const auto id = static_cast<uint32_t>(static_cast<float>(args[0]));
+            if (id < modules_by_id_.size()) target = modules_by_id_[id];
+        }
+        if (!target || !target->client_eventhandler) return {};
+        game_value ret{};
+        target->client_eventhandler(ret, static_cast<uint8_t>(static_cast<int>(args[1])), static_cast<int32_t>(static_cast<float>(args[2])), static_cast<int>(args[3]), right_.to_array()[0]);
+        return ret;
+    }
+
+    void eventhandler_route_by_name(::benchmark::State &state_) {
+        loaded_modules modules;
+        const auto events = make_frame(false);
+        handled = 0;
+        for (auto _ : state_) {
+            for (auto &event : events) by_name(modules.by_name, event.first, event.second);
+        }
+        ::benchmark::DoNotOptimize(handled);
+        state_.SetItemsProcessed(state_.iterations() * events_per_frame);
+    }
+    BENCHMARK(eventhandler_route_by_name)->Unit(::benchmark::kMicrosecond);
+
+    void eventhandler_route_by_id(::benchmark::State &state_) {
+        loaded_modules modules;
+        const auto events = make_frame(true);
+        handled = 0;
+        for (auto _ : state_) {
+            for (auto &event : events) by_id(modules.by_id, event.first, event.second);
+        }
+        ::benchmark::DoNotOptimize(handled);
+        state_.SetItemsProcessed(state_.iterations() * events_per_frame);
+    }
+    BENCHMARK(eventhandler_route_by_id)->Unit(::benchmark::kMicrosecond);
+}  // namespace
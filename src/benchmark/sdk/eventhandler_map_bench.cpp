@@ -0,0 +1,141 @@
+/*!
+@file
+@brief Replays eventhandler bookkeeping on std::unordered_map and on eh_flat_map.
+
+The trace is recorded once, both maps then replay the exact same operations:
+a mission start that registers a few thousand handlers, then frames that
+mostly route events to existing handlers, with handlers being added and
+removed in between, and a few events for handlers that are gone.
+*/
+#include "client/eventhandler_map.hpp"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace intercept::client;
+
+namespace {
+    constexpr size_t initial_handlers = 3000;
+    constexpr size_t operations = 2000000;
+
+    enum class operation_type : uint8_t {
+        add,
+        remove,
+        lookup
+    };
+
+    struct operation {
+        operation_type type;
+        EHIdentifier ident;
+    };
+
+    //Handlers are identified like the client does it, a random uid and an id counting up per type
+    std::vector<operation> record_trace() {
+        std::mt19937 rng(1234);
+        std::uniform_int_distribution<int32_t> uid(-16777215, 16777215);
+        std::uniform_int_distribution<int> type(0, 4);
+        std::uniform_int_distribution<int> roll(0, 999);
+        int next_eh_id[5] = {};
+
+        std::vector<EHIdentifier> live;
+        std::vector<EHIdentifier> removed;
+        std::vector<operation> trace;
+        trace.reserve(initial_handlers + operations);
+
+        auto add = [&]() {
+            const auto eh_type = type(rng);
+            EHIdentifier ident{uid(rng), next_eh_id[eh_type]++, 0, static_cast<uint8_t>(eh_type)};
+            live.push_back(ident);
+            trace.push_back({operation_type::add, ident});
+        };
+
+        for (size_t i = 0; i < initial_handlers; ++i) add();
+        while (trace.size() < initial_handlers + operations) {
+            const auto chance = roll(rng);
+            if (chance < 20) {
+                add();
+            } else if (chance < 40 && !live.empty()) {
+                const auto index = std::uniform_int_distribution<size_t>(0, live.size() - 1)(rng);
+                trace.push_back({operation_type::remove, live[index]});
+                removed.push_back(live[index]);
+                live[index] = live.back();
+                live.pop_back();
+            } else if (chance < 45 && !removed.empty()) {
+                //The engine can still fire a handler that the plugin already removed
+                trace.push_back({operation_type::lookup, removed[std::uniform_int_distribution<size_t>(0, removed.size() - 1)(rng)]});
+            } else if (!live.empty()) {
+                trace.push_back({operation_type::lookup, live[std::uniform_int_distribution<size_t>(0, live.size() - 1)(rng)]});
+            }
+        }
+        return trace;
+    }
+
+    const std::vector<operation> &trace() {
+        static const auto trace = record_trace();
+        return trace;
+    }
+
+    //Big enough that the values don't fit in the slots, like eh_callback
+    struct callback {
+        int calls = 0;
+        char payload[72];
+    };
+
+    struct unordered_map_replay {
+        std::unordered_map<EHIdentifier, callback, EHIdentifier_hasher> map;
+
+        void add(const EHIdentifier &ident_) { map[ident_].calls = 0; }
+        void remove(const EHIdentifier &ident_) { map.erase(ident_); }
+        bool lookup(const EHIdentifier &ident_) {
+            auto found = map.find(ident_);
+            if (found == map.end()) return false;
+            ++found->second.calls;
+            return true;
+        }
+    };
+
+    struct flat_map_replay {
+        eh_flat_map<callback> map;
+
+        void add(const EHIdentifier &ident_) { map[ident_].calls = 0; }
+        void remove(const EHIdentifier &ident_) { map.erase(ident_); }
+        bool lookup(const EHIdentifier &ident_) {
+            auto found = map.find(ident_);
+            if (!found) return false;
+            ++found->calls;
+            return true;
+        }
+    };
+
+    template <typename Replay>
+    size_t replay(const std::vector<operation> &trace_) {
+        Replay replay;
+        size_t hits = 0;
+        for (auto &op : trace_) {
+            switch (op.type) {
+                case operation_type::add: replay.add(op.ident); break;
+                case operation_type::remove: replay.remove(op.ident); break;
+                case operation_type::lookup: hits += replay.lookup(op.ident); break;
+            }
+        }
+        return hits;
+    }
+
+    template <typename Replay>
+    void eventhandler_map_replay(::benchmark::State &state_) {
+        auto &operations = trace();
+        //std::unordered_map is the reference, every map has to find the same handlers
+        static const size_t expected_hits = replay<unordered_map_replay>(operations);
+        size_t hits = 0;
+        for (auto _ : state_) {
+            hits = replay<Replay>(operations);
+            ::benchmark::DoNotOptimize(hits);
+        }
+        if (hits != expected_hits) state_.SkipWithError("hit counts differ from std::unordered_map");
+        state_.SetItemsProcessed(state_.iterations() * operations.size());
+        state_.counters["hits"] = static_cast<double>(hits);
+    }
+    BENCHMARK_TEMPLATE(eventhandler_map_replay, unordered_map_replay)->Unit(::benchmark::kMillisecond);
+    BENCHMARK_TEMPLATE(eventhandler_map_replay, flat_map_replay)->Unit(::benchmark::kMillisecond);
+}  // namespace
@@ -0,0 +1,43 @@
+/*!
+@file
+@brief find_key_array uniqueness insertion with and without the side index.
+*/
+#include "shared/types.hpp"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace intercept::types;
+
+namespace {
+    template <bool Indexed>
+    void find_key_array_push_back_unique(::benchmark::State &state_) {
+        //Every value twice, so half of the pushes are rejected
+        std::vector<game_value> values;
+        for (int64_t i = 0; i < state_.range(0); ++i) values.emplace_back(static_cast<float>(i / 2));
+
+        for (auto _ : state_) {
+            find_key_array<game_value, find_key_array_traits<game_value>, Indexed> array;
+            for (auto &value : values) array.push_back_unique(value);
+            ::benchmark::DoNotOptimize(array.data());
+        }
+        state_.SetItemsProcessed(state_.iterations() * state_.range(0));
+    }
+    BENCHMARK_TEMPLATE(find_key_array_push_back_unique, false)->Range(64, 16 << 10);
+    BENCHMARK_TEMPLATE(find_key_array_push_back_unique, true)->Range(64, 16 << 10);
+
+    template <bool Indexed>
+    void find_key_array_delete_by_key(::benchmark::State &state_) {
+        find_key_array<game_value, find_key_array_traits<game_value>, Indexed> array;
+        for (int64_t i = 0; i < state_.range(0); ++i) array.push_back(game_value(static_cast<float>(i)));
+
+        //Removes one of the last elements and puts it back, the index gets rebuilt every time
+        int64_t next = 0;
+        for (auto _ : state_) {
+            const game_value value(static_cast<float>(state_.range(0) - 1 - next++ % 8));
+            array.delete_by_key(value);
+            array.push_back(value);
+        }
+    }
+    BENCHMARK_TEMPLATE(find_key_array_delete_by_key, false)->Range(64, 16 << 10);
+    BENCHMARK_TEMPLATE(find_key_array_delete_by_key, true)->Range(64, 16 << 10);
+}  // namespace
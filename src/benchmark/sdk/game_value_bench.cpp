@@ -0,0 +1,99 @@
+/*!
+@file
+@brief game_value construction and conversion round trips, and hash and == on nested arrays.
+*/
+#include "shared/types.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+using namespace intercept::types;
+
+namespace {
+    //Arrays nested depth_ levels deep, every level holds width_ elements. The leaves alternate between numbers and strings
+    game_value make_nested_array(int depth_, int width_, int &leaf_) {
+        auto_array<game_value> elements;
+        elements.reserve(width_);
+        for (int i = 0; i < width_; ++i) {
+            if (depth_ > 1) {
+                elements.emplace_back(make_nested_array(depth_ - 1, width_, leaf_));
+            } else if (leaf_++ % 2) {
+                elements.emplace_back(static_cast<float>(leaf_));
+            } else {
+                elements.emplace_back("leaf_" + std::to_string(leaf_));
+            }
+        }
+        return game_value(std::move(elements));
+    }
+
+    game_value make_nested_array(int depth_, int width_) {
+        int leaf = 0;
+        return make_nested_array(depth_, width_, leaf);
+    }
+
+    void game_value_float_round_trip(::benchmark::State &state_) {
+        float value = 1.f;
+        for (auto _ : state_) {
+            const game_value converted(value);
+            value = static_cast<float>(converted) + 1.f;
+            ::benchmark::DoNotOptimize(value);
+        }
+    }
+    BENCHMARK(game_value_float_round_trip);
+
+    void game_value_bool_round_trip(::benchmark::State &state_) {
+        bool value = true;
+        for (auto _ : state_) {
+            const game_value converted(value);
+            value = !static_cast<bool>(converted);
+            ::benchmark::DoNotOptimize(value);
+        }
+    }
+    BENCHMARK(game_value_bool_round_trip);
+
+    void game_value_string_round_trip(::benchmark::State &state_) {
+        const std::string value(static_cast<size_t>(state_.range(0)), 'x');
+        for (auto _ : state_) {
+            const game_value converted(value);
+            auto result = static_cast<std::string>(converted);
+            ::benchmark::DoNotOptimize(result);
+        }
+    }
+    BENCHMARK(game_value_string_round_trip)->Arg(8)->Arg(64)->Arg(1024);
+
+    void game_value_vector3_round_trip(::benchmark::State &state_) {
+        vector3 value{1.f, 2.f, 3.f};
+        for (auto _ : state_) {
+            const game_value converted(value);
+            value = static_cast<vector3>(converted);
+            ::benchmark::DoNotOptimize(value);
+        }
+    }
+    BENCHMARK(game_value_vector3_round_trip);
+
+    void game_value_nested_array_round_trip(::benchmark::State &state_) {
+        const auto depth = static_cast<int>(state_.range(0));
+        for (auto _ : state_) {
+            const auto converted = make_nested_array(depth, 4);
+            //Walks down the first element of every level like a plugin reading a nested result
+            const game_value *level = &converted;
+            while (level->type_enum() == game_data_type::ARRAY) level = &level->to_array()[0];
+            auto leaf = static_cast<std::string>(*level);
+            ::benchmark::DoNotOptimize(leaf);
+        }
+    }
+    BENCHMARK(game_value_nested_array_round_trip)->DenseRange(1, 4);
+
+    void game_value_hash_nested_array(::benchmark::State &state_) {
+        const auto value = make_nested_array(static_cast<int>(state_.range(0)), 4);
+        for (auto _ : state_) ::benchmark::DoNotOptimize(value.hash());
+    }
+    BENCHMARK(game_value_hash_nested_array)->DenseRange(1, 5);
+
+    void game_value_equal_nested_array(::benchmark::State &state_) {
+        //Equal but separate copies, so every element gets compared
+        const auto left = make_nested_array(static_cast<int>(state_.range(0)), 4);
+        const auto right = make_nested_array(static_cast<int>(state_.range(0)), 4);
+        for (auto _ : state_) ::benchmark::DoNotOptimize(left == right);
+    }
+    BENCHMARK(game_value_equal_nested_array)->DenseRange(1, 5);
+}  // namespace
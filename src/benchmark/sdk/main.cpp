@@ -0,0 +1,25 @@
+/*!
+@file
+@brief Google Benchmark suite for the client SDK hot paths, run against engine_stub.
+
+Every benchmark runs on the same engine stand-in, so results stay comparable
+between SDK versions. Export them with
+--benchmark_out=intercept_bench.json --benchmark_out_format=json, or build the
+intercept_bench_json target.
+*/
+#include "engine_stub.hpp"
+#include "shared/functions.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+int main(int argc, char **argv) {
+    intercept::benchmark::install_engine_stub();
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    //Lands in the context section of the JSON output, to tell runs of different SDK versions apart
+    ::benchmark::AddCustomContext("intercept_sdk_api_version", std::to_string(INTERCEPT_SDK_API_VERSION));
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*!
+@file
+@brief map_string_to_class and string_map insert and lookup, with case sensitive and case insensitive traits.
+
+Keys look like variable names, which is what the engine keeps in these maps.
+*/
+#include "shared/types.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+using namespace intercept::types;
+
+namespace {
+    //The engine owns these maps and never frees them through the SDK, this one cleans up after itself
+    template <class Traits>
+    class variable_map : public map_string_to_class<game_variable, auto_array<game_variable>, Traits> {
+    public:
+        ~variable_map() {
+            if (this->_table) rv_allocator<auto_array<game_variable>>::destroy_deallocate(this->_table, this->_tableCount);
+        }
+    };
+
+    std::vector<r_string> make_keys(int64_t count_, const char *prefix_) {
+        std::vector<r_string> keys;
+        keys.reserve(static_cast<size_t>(count_));
+        for (int64_t i = 0; i < count_; ++i) keys.emplace_back(prefix_ + std::to_string(i));
+        return keys;
+    }
+
+    template <class Map>
+    void insert_keys(::benchmark::State &state_) {
+        const auto keys = make_keys(state_.range(0), "mission_var_");
+        const game_value value(1.f);
+        for (auto _ : state_) {
+            Map map;
+            for (auto &key : keys) map.insert(game_variable(key, value));
+            ::benchmark::DoNotOptimize(map.count());
+        }
+        state_.SetItemsProcessed(state_.iterations() * state_.range(0));
+    }
+
+    template <class Map>
+    void lookup_keys(::benchmark::State &state_) {
+        const auto keys = make_keys(state_.range(0), "mission_var_");
+        //Half of the lookups miss
+        const auto misses = make_keys(state_.range(0), "mission_vaR_");
+        Map map;
+        for (auto &key : keys) map.insert(game_variable(key, game_value(1.f)));
+
+        size_t index = 0;
+        for (auto _ : state_) {
+            auto &key = (index & 1) ? misses[index / 2 % misses.size()] : keys[index / 2 % keys.size()];
+            ::benchmark::DoNotOptimize(&map.get(key));
+            ++index;
+        }
+    }
+
+    template <class Traits>
+    void map_string_to_class_insert(::benchmark::State &state_) { insert_keys<variable_map<Traits>>(state_); }
+    BENCHMARK_TEMPLATE(map_string_to_class_insert, map_string_to_class_trait)->Range(64, 16 << 10);
+    BENCHMARK_TEMPLATE(map_string_to_class_insert, map_string_to_class_trait_caseinsensitive)->Range(64, 16 << 10);
+
+    template <class Traits>
+    void map_string_to_class_lookup(::benchmark::State &state_) { lookup_keys<variable_map<Traits>>(state_); }
+    BENCHMARK_TEMPLATE(map_string_to_class_lookup, map_string_to_class_trait)->Range(64, 16 << 10);
+    BENCHMARK_TEMPLATE(map_string_to_class_lookup, map_string_to_class_trait_caseinsensitive)->Range(64, 16 << 10);
+
+    template <class Traits>
+    void string_map_insert(::benchmark::State &state_) { insert_keys<string_map<game_variable, Traits>>(state_); }
+    BENCHMARK_TEMPLATE(string_map_insert, string_map_trait)->Range(64, 16 << 10);
+    BENCHMARK_TEMPLATE(string_map_insert, string_map_trait_caseinsensitive)->Range(64, 16 << 10);
+
+    template <class Traits>
+    void string_map_lookup(::benchmark::State &state_) { lookup_keys<string_map<game_variable, Traits>>(state_); }
+    BENCHMARK_TEMPLATE(string_map_lookup, string_map_trait)->Range(64, 16 << 10);
+    BENCHMARK_TEMPLATE(string_map_lookup, string_map_trait_caseinsensitive)->Range(64, 16 << 10);
+}  // namespace
@@ -0,0 +1,52 @@
+/*!
+@file
+@brief r_string comparisons and length.
+*/
+#include "shared/containers.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+using namespace intercept::types;
+
+namespace {
+    //Strings that only differ in their last character, so every comparison looks at all of them
+    std::string make_string(int64_t length_, char last_) {
+        std::string result(static_cast<size_t>(length_), 'a');
+        if (!result.empty()) result.back() = last_;
+        return result;
+    }
+
+    void r_string_equal(::benchmark::State &state_) {
+        const r_string left(make_string(state_.range(0), 'x'));
+        const r_string right(make_string(state_.range(0), 'x'));
+        for (auto _ : state_) ::benchmark::DoNotOptimize(left == right);
+    }
+    BENCHMARK(r_string_equal)->Arg(8)->Arg(64)->Arg(1024);
+
+    void r_string_equal_string_view(::benchmark::State &state_) {
+        const r_string left(make_string(state_.range(0), 'x'));
+        const auto right = make_string(state_.range(0), 'y');
+        for (auto _ : state_) ::benchmark::DoNotOptimize(left == std::string_view(right));
+    }
+    BENCHMARK(r_string_equal_string_view)->Arg(8)->Arg(64)->Arg(1024);
+
+    void r_string_compare_case_insensitive(::benchmark::State &state_) {
+        const r_string left(make_string(state_.range(0), 'x'));
+        const auto right = make_string(state_.range(0), 'X');
+        for (auto _ : state_) ::benchmark::DoNotOptimize(left.compare_case_insensitive(right));
+    }
+    BENCHMARK(r_string_compare_case_insensitive)->Arg(8)->Arg(64)->Arg(1024);
+
+    void r_string_less(::benchmark::State &state_) {
+        const r_string left(make_string(state_.range(0), 'x'));
+        const r_string right(make_string(state_.range(0), 'y'));
+        for (auto _ : state_) ::benchmark::DoNotOptimize(left < right);
+    }
+    BENCHMARK(r_string_less)->Arg(8)->Arg(64)->Arg(1024);
+
+    void r_string_length(::benchmark::State &state_) {
+        const r_string value(make_string(state_.range(0), 'x'));
+        for (auto _ : state_) ::benchmark::DoNotOptimize(value.length());
+    }
+    BENCHMARK(r_string_length)->Arg(8)->Arg(1024);
+}  // namespace
@@ -1,6 +1,7 @@
 #pragma once
 #include "../shared.hpp"
 #include "shared/functions.hpp"
+#include <future>
 
 namespace intercept {
     namespace client {
@@ -15,7 +16,11 @@ namespace intercept {
         class host {
         public:
             static client_functions functions;
+            ///Functions of API version 3 and later, all null if the host is older
+            static client_functions_v3 functions_v3;
             static r_string module_name;
+            ///Id the host knows this module by, passed in InterceptClientEvent calls instead of the name
+            static uint32_t module_id;
            
 
             ///@copydoc intercept::sqf_functions::register_sqf_function(std::string_view, std::string_view, WrapperFunctionBinary, types::game_data_type, types::game_data_type, types::game_data_type)
@@ -70,6 +75,16 @@ namespace intercept {
             ///@copydoc intercept::extensions::request_plugin_interface
             static std::optional<void*> request_plugin_interface(std::string_view name_, uint32_t api_version_);
 
+            /*!@{
+            @brief Queues a raw SQF function call for the next invoke period without taking the invoker lock.
+            @details The promise behind the returned future lives in this module, the host only sees a callback.
+            @see intercept::client_functions_v3::invoke_raw_nular_async
+            */
+            static std::future<game_value> invoke_raw_async(nular_function function_);
+            static std::future<game_value> invoke_raw_async(unary_function function_, const game_value &right_arg_);
+            static std::future<game_value> invoke_raw_async(binary_function function_, const game_value &left_arg_, const game_value &right_arg_);
+            //!@}
+
 
         };
 
@@ -78,6 +93,8 @@ namespace intercept {
         extern "C" {
             /// @private
             DLLEXPORT void CDECL assign_functions(const struct client_functions funcs, r_string module_name);
+            /// @private Called right after assign_functions by hosts of API version 3 or later
+            DLLEXPORT void CDECL assign_functions_v3(const struct client_functions_v3 *funcs, r_string module_name);
         }
         /// @private
         void __initialize();
@@ -0,0 +1,195 @@
+/*!
+@file
+@brief Open addressing hash map for the eventhandler callbacks of a plugin.
+
+Every engine event that is routed to a plugin looks its callback up by
+EHIdentifier, so the lookup is kept to one probe into a compact table most of
+the time.
+*/
+#pragma once
+#include "../shared/types.hpp"
+#include "../shared/swiss_table.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace intercept::client {
+    /// @private
+    struct EHIdentifier {
+        int32_t internal_id;
+        int arma_eh_id;
+        uint32_t EHIteration;
+        uint8_t EHType;
+        bool already_deleted = false;
+        bool operator==(const EHIdentifier& other) const {
+            return internal_id == other.internal_id && arma_eh_id == other.arma_eh_id && EHType == other.EHType;
+        }
+
+
+    };
+
+
+    /// @private
+    struct EHIdentifier_hasher {
+        size_t operator()(const intercept::client::EHIdentifier& x) const {
+            using intercept::types::__internal::pairhash;
+            return pairhash(pairhash(x.internal_id, x.arma_eh_id), x.EHType);
+        }
+    };
+
+    /**
+     * @brief Map from EHIdentifier to Value, laid out like a SwissTable, see types::__internal::swiss_control.
+     * @description Slots only hold the key and an index, the values are kept in fixed size chunks on the side. That keeps the
+     * probed memory small, and a value never moves while it is in the map, even if the table grows. A callback
+     * can therefore add other callbacks while it is running.
+     * Not threadsafe, like the rest of the eventhandler bookkeeping it's only used from the main thread.
+     * @private
+     */
+    template <typename Value>
+    class eh_flat_map {
+    public:
+        eh_flat_map() = default;
+        eh_flat_map(const eh_flat_map&) = delete;
+        eh_flat_map& operator=(const eh_flat_map&) = delete;
+
+        size_t size() const noexcept { return _size; }
+        bool empty() const noexcept { return _size == 0; }
+
+        /**
+         * @brief Returns the value of key_, or nullptr if it isn't in the map.
+         */
+        Value* find(const EHIdentifier& key_) noexcept {
+            if (!_size) return nullptr;
+            const auto hash = hash_of(key_);
+            const auto index = find_slot(key_, hash);
+            return index == npos ? nullptr : &value_at(_slots[index].value);
+        }
+
+        Value& operator[](const EHIdentifier& key_) {
+            const auto hash = hash_of(key_);
+            if (_size) {
+                const auto index = find_slot(key_, hash);
+                if (index != npos) return value_at(_slots[index].value);
+            }
+            if (_size + _deleted + 1 > max_load(_capacity)) grow();
+
+            uint32_t value;
+            if (!_free_values.empty()) {
+                value = _free_values.back();
+                _free_values.pop_back();
+            } else {
+                value = static_cast<uint32_t>(_value_count++);
+                if (value / chunk_size == _values.size()) _values.emplace_back(std::make_unique<Value[]>(chunk_size));
+            }
+            const auto index = insert_slot(hash);
+            _slots[index] = {key_, value};
+            ++_size;
+            return value_at(value);
+        }
+
+        bool erase(const EHIdentifier& key_) {
+            if (!_size) return false;
+            const auto index = find_slot(key_, hash_of(key_));
+            if (index == npos) return false;
+
+            control::erase(_control.get(), index, _deleted);
+            --_size;
+
+            //Hand the value out of the map before destroying it, its destructor might erase other entries
+            const auto value = _slots[index].value;
+            Value discarded = std::move(value_at(value));
+            value_at(value) = Value();
+            _free_values.push_back(value);
+            return true;
+        }
+
+        /**
+         * @brief Removes all entries, the table keeps its capacity.
+         * @description The map is already empty when the values are destroyed, so a value whose destructor erases
+         * entries of this map doesn't find anything.
+         */
+        void clear() {
+            if (!_size && _values.empty()) return;
+            std::memset(_control.get(), control::empty, _capacity);
+            _size = 0;
+            _deleted = 0;
+            _free_values.clear();
+            _value_count = 0;
+            std::vector<std::unique_ptr<Value[]>> discarded;
+            discarded.swap(_values);
+        }
+
+        /**
+         * @brief Calls func_(key, value) for every entry.
+         */
+        template <typename Func>
+        void for_each(Func&& func_) {
+            for (size_t i = 0; i < _capacity; ++i) {
+                if (control::is_full(_control[i])) func_(static_cast<const EHIdentifier&>(_slots[i].key), value_at(_slots[i].value));
+            }
+        }
+
+    private:
+        using control = types::__internal::swiss_control;
+        static constexpr size_t npos = control::npos;
+        static constexpr size_t chunk_size = 64;
+
+        struct slot {
+            EHIdentifier key;
+            uint32_t value;
+        };
+
+        Value& value_at(uint32_t index_) noexcept { return _values[index_ / chunk_size][index_ % chunk_size]; }
+
+        static size_t max_load(size_t capacity_) noexcept { return control::max_load(capacity_); }
+
+        static uint64_t hash_of(const EHIdentifier& key_) noexcept {
+            //The same fields operator== compares. internal_id is random, arma_eh_id counts up from 0
+            uint64_t hash = (static_cast<uint64_t>(static_cast<uint32_t>(key_.internal_id)) << 32) | static_cast<uint32_t>(key_.arma_eh_id);
+            hash ^= static_cast<uint64_t>(key_.EHType) << 56;
+            hash *= 0x9E3779B97F4A7C15ull;
+            return hash ^ (hash >> 29);
+        }
+        size_t find_slot(const EHIdentifier& key_, uint64_t hash_) const noexcept {
+            return control::find(_control.get(), _capacity, hash_, [this, &key_](size_t index_) { return _slots[index_].key == key_; });
+        }
+
+        size_t insert_slot(uint64_t hash_) noexcept {
+            return control::insert(_control.get(), _capacity, hash_, _deleted);
+        }
+
+        void grow() {
+            auto old_control = std::move(_control);
+            auto old_slots = std::move(_slots);
+            const auto old_capacity = _capacity;
+
+            //Only grow if the table is really full, lots of deleted entries just need a cleanup
+            size_t capacity = old_capacity ? old_capacity : control::group_size * 2;
+            while (max_load(capacity) <= _size + 1) capacity *= 2;
+            _capacity = capacity;
+            _control = std::make_unique<uint8_t[]>(_capacity);
+            std::memset(_control.get(), control::empty, _capacity);
+            _slots = std::make_unique<slot[]>(_capacity);
+            _deleted = 0;
+
+            for (size_t i = 0; i < old_capacity; ++i) {
+                if (!control::is_full(old_control[i])) continue;
+                const auto index = insert_slot(hash_of(old_slots[i].key));
+                _slots[index] = old_slots[i];
+            }
+        }
+
+        std::unique_ptr<uint8_t[]> _control;
+        std::unique_ptr<slot[]> _slots;
+        size_t _capacity = 0;
+        size_t _size = 0;
+        size_t _deleted = 0;
+
+        //Chunks never move, so neither do the values
+        std::vector<std::unique_ptr<Value[]>> _values;
+        size_t _value_count = 0;
+        std::vector<uint32_t> _free_values;
+    };
+}  // namespace intercept::client
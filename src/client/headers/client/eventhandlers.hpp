@@ -18,9 +18,16 @@ Provides the ability to assign Eventhandlers without going through SQF
 #endif
 
 #include "../shared/client_types.hpp"
+#include "eventhandler_map.hpp"
 
 #ifndef INTERCEPT_NO_SQF
+#include <cstddef>
 #include <functional>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 namespace intercept::client {
 
@@ -30,29 +37,217 @@ namespace intercept::client {
         continuesave  ///< saved when leaving a mission to the main menu
     };
     
+    /**
+     * @brief Converts the SQF eventhandler argument at index_ to Type.
+     * @description width is the number of SQF arguments a parameter of that type takes. Specialize it for
+     * parameter types that don't convert from a single game_value.
+     * @private
+     */
+    template <typename Type>
+    struct eh_argument {
+        static constexpr size_t width = 1;
+        static Type decode(types::game_value_parameter args_, size_t index_) {
+            return args_[index_];
+        }
+    };
+
     /// @private
-    struct EHIdentifier {
-        int32_t internal_id;
-        int arma_eh_id;
-        uint32_t EHIteration;
-        uint8_t EHType;
-        bool already_deleted = false;
-        bool operator==(const EHIdentifier& other) const {
-            return internal_id == other.internal_id && arma_eh_id == other.arma_eh_id && EHType == other.EHType;
+    template <>
+    struct eh_argument<types::vector2> {
+        //Eventhandlers pass positions on screen as two separate numbers
+        static constexpr size_t width = 2;
+        static types::vector2 decode(types::game_value_parameter args_, size_t index_) {
+            return {static_cast<float>(args_[index_]), static_cast<float>(args_[index_ + 1])};
         }
+    };
+
+    /// @private
+    template <typename Type>
+    struct eh_argument<types::auto_array<Type>> {
+        static constexpr size_t width = 1;
+        static types::auto_array<Type> decode(types::game_value_parameter args_, size_t index_) {
+            auto& array = args_[index_].to_array();
+            return types::auto_array<Type>(array.begin(), array.end());
+        }
+    };
+
+    /// @private
+    template <>
+    struct eh_argument<types::rv_turret_path> {
+        static constexpr size_t width = 1;
+        static types::rv_turret_path decode(types::game_value_parameter args_, size_t index_) {
+            return types::rv_turret_path(args_[index_]);
+        }
+    };
+
+    /// @private
+    template <>
+    struct eh_argument<loaded_saveType> {
+        static constexpr size_t width = 1;
+        static loaded_saveType decode(types::game_value_parameter args_, size_t index_) {
+            using namespace std::literals;
+            auto type = static_cast<types::r_string>(args_[index_]);
+            if (type == "autosave"sv) return loaded_saveType::autosave;
+            if (type == "continue"sv) return loaded_saveType::continuesave;
+            return loaded_saveType::save;
+        }
+    };
 
+    /// @private
+    template <typename Result>
+    struct eh_result {
+        static types::game_value convert(Result&& result_) { return types::game_value(std::move(result_)); }
+    };
 
+    /// @private
+    template <typename Result>
+    struct eh_result<std::optional<Result>> {
+        //An empty optional leaves the engines default
+        static types::game_value convert(std::optional<Result>&& result_) {
+            if (result_) return types::game_value(*result_);
+            return {};
+        }
     };
 
+    /**
+     * @brief Calls a handler with signature Return(Args...) with the arguments of an SQF eventhandler.
+     * @description The arguments are decoded in order into a tuple on the stack and applied to the handler, which
+     * is the only conversion that happens between the engine calling the eventhandler and the handler.
+     * @private
+     */
+    template <typename Signature>
+    struct eh_dispatcher;
 
     /// @private
-    struct EHIdentifier_hasher {
-        size_t operator()(const intercept::client::EHIdentifier& x) const {
-            using intercept::types::__internal::pairhash;
-            return pairhash(pairhash(x.internal_id, x.arma_eh_id), x.EHType);
+    template <typename Return, typename... Args>
+    struct eh_dispatcher<Return(Args...)> {
+        template <typename Func>
+        static types::game_value invoke(Func& function_, types::game_value_parameter args_) {
+            auto values = decode(args_, std::index_sequence_for<Args...>());
+            if constexpr (std::is_void_v<Return>) {
+                std::apply(function_, std::move(values));
+                return {};
+            } else {
+                return eh_result<Return>::convert(std::apply(function_, std::move(values)));
+            }
+        }
+
+    private:
+        static constexpr size_t widths[] = {eh_argument<std::decay_t<Args>>::width..., 0};
+
+        static constexpr size_t offset_of(size_t argument_) {
+            size_t offset = 0;
+            for (size_t i = 0; i < argument_; ++i) offset += widths[i];
+            return offset;
+        }
+
+        template <size_t... Index>
+        static std::tuple<std::decay_t<Args>...> decode(types::game_value_parameter args_, std::index_sequence<Index...>) {
+            //Braced initialization decodes left to right
+            return std::tuple<std::decay_t<Args>...>{eh_argument<std::decay_t<Args>>::decode(args_, offset_of(Index))...};
+        }
+    };
+
+    /// @private
+    struct eh_passthrough_dispatcher {
+        template <typename Func>
+        static types::game_value invoke(Func& function_, types::game_value_parameter args_) {
+            return function_(args_);
+        }
+    };
+
+    /**
+     * @brief A stored eventhandler callback together with the dispatcher that decodes its arguments.
+     * @description Callables up to inline_size bytes, which includes std::function, are stored inside the
+     * callback and larger ones on the heap. Calling it is a single indirect call into the dispatcher generated
+     * for the eventhandlers signature, nothing is refcounted.
+     * @private
+     */
+    class eh_callback {
+    public:
+        static constexpr size_t inline_size = 64;
+
+        template <typename Dispatcher, typename Func>
+        static eh_callback create(Func&& function_) {
+            using stored_type = std::decay_t<Func>;
+            eh_callback callback;
+            if constexpr (fits_inline<stored_type>) {
+                new (callback._storage) stored_type(std::forward<Func>(function_));
+                callback._invoke = [](void* storage_, types::game_value_parameter args_) {
+                    return Dispatcher::invoke(*std::launder(static_cast<stored_type*>(storage_)), args_);
+                };
+                callback._manage = [](void* storage_, void* move_to_) {
+                    auto& function = *std::launder(static_cast<stored_type*>(storage_));
+                    if (move_to_) new (move_to_) stored_type(std::move(function));
+                    function.~stored_type();
+                };
+            } else {
+                *reinterpret_cast<stored_type**>(callback._storage) = new stored_type(std::forward<Func>(function_));
+                callback._invoke = [](void* storage_, types::game_value_parameter args_) {
+                    return Dispatcher::invoke(**static_cast<stored_type**>(storage_), args_);
+                };
+                callback._manage = [](void* storage_, void* move_to_) {
+                    auto& function = *static_cast<stored_type**>(storage_);
+                    if (move_to_)
+                        *static_cast<stored_type**>(move_to_) = function;
+                    else
+                        delete function;
+                    function = nullptr;
+                };
+            }
+            return callback;
+        }
+
+        eh_callback() noexcept = default;
+        eh_callback(eh_callback&& other_) noexcept { take(other_); }
+        eh_callback& operator=(eh_callback&& other_) noexcept {
+            if (this != &other_) {
+                reset();
+                take(other_);
+            }
+            return *this;
+        }
+        eh_callback(const eh_callback&) = delete;
+        eh_callback& operator=(const eh_callback&) = delete;
+        ~eh_callback() { reset(); }
+
+        types::game_value operator()(types::game_value_parameter args_) { return _invoke(_storage, args_); }
+        explicit operator bool() const noexcept { return _invoke != nullptr; }
+
+    private:
+        template <typename Type>
+        static constexpr bool fits_inline = sizeof(Type) <= inline_size && alignof(Type) <= alignof(std::max_align_t) &&
+                                            std::is_nothrow_move_constructible_v<Type>;
+
+        void reset() noexcept {
+            if (_manage) _manage(_storage, nullptr);
+            _invoke = nullptr;
+            _manage = nullptr;
         }
+        void take(eh_callback& other_) noexcept {
+            if (other_._manage) other_._manage(other_._storage, _storage);
+            _invoke = other_._invoke;
+            _manage = other_._manage;
+            other_._invoke = nullptr;
+            other_._manage = nullptr;
+        }
+
+        alignas(std::max_align_t) unsigned char _storage[inline_size];
+        types::game_value (*_invoke)(void* storage_, types::game_value_parameter args_) = nullptr;
+        //Destroys the callable, after moving it to move_to_ if that isn't null
+        void (*_manage)(void* storage_, void* move_to_) = nullptr;
     };
 
+    /// @private
+    using eh_callback_map = eh_flat_map<eh_callback>;
+
+    /**
+     * @brief Removes the callback of id from map_.
+     * @description If the callback is running right now, it is removed once it returned.
+     * @private
+     */
+    void eraseEHCallback(eh_callback_map& map_, const EHIdentifier& id);
+
 
     
     /**
@@ -182,28 +377,27 @@ namespace intercept::client {
     */
     EHDEF_MISSION(COMPILETIME_CHECK_ENUM_MISSION)
 
-    /// @private
-    intercept::types::game_value callEHHandler(eventhandlers_mission ehType, intercept::types::game_value args, std::shared_ptr<std::function<void()>> func);
 
     /// @private
     EHIdentifier addScriptEH(eventhandlers_mission type);
     /// @private
     void delScriptEH(eventhandlers_mission type, EHIdentifier& handle);
     /// @private
-    extern std::unordered_map<EHIdentifier, std::pair<eventhandlers_mission, std::shared_ptr<std::function<void()>>>, EHIdentifier_hasher> funcMapMissionEH;
+    extern eh_callback_map funcMapMissionEH;
     /// @private
     template <eventhandlers_mission Type>
     struct __addMissionEventHandler_Impl;
 
-#define EH_Add_Mission_definition(name, retVal, fncArg)                                                                                                             \
-    template <>                                                                                                                                                     \
-    struct __addMissionEventHandler_Impl<eventhandlers_mission::name> {                                                                                             \
-        using fncType = std::function<retVal(fncArg)>;                                                                                                              \
-        [[nodiscard]] static EHIdentifier add(std::function<retVal(fncArg)> function) {                                                                             \
-            auto ident = addScriptEH(eventhandlers_mission::name);                                                                                                  \
-            funcMapMissionEH[ident] = {eventhandlers_mission::name, std::make_shared<std::function<void()>>(*reinterpret_cast<std::function<void()>*>(&function))}; \
-            return ident;                                                                                                                                           \
-        }                                                                                                                                                           \
+#define EH_Add_Mission_definition(name, retVal, fncArg)                                                                 \
+    template <>                                                                                                         \
+    struct __addMissionEventHandler_Impl<eventhandlers_mission::name> {                                                 \
+        using fncType = std::function<retVal(fncArg)>;                                                                  \
+        template <typename Func>                                                                                        \
+        [[nodiscard]] static EHIdentifier add(Func&& function) {                                                        \
+            auto ident = addScriptEH(eventhandlers_mission::name);                                                      \
+            funcMapMissionEH[ident] = eh_callback::create<eh_dispatcher<retVal(fncArg)>>(std::forward<Func>(function)); \
+            return ident;                                                                                               \
+        }                                                                                                               \
     };
 
     EHDEF_MISSION(EH_Add_Mission_definition)
@@ -217,7 +411,7 @@ namespace intercept::client {
     */
     template <eventhandlers_mission Type, typename Func = typename __addMissionEventHandler_Impl<Type>::fncType>
     [[nodiscard]] EHIdentifierHandle addMissionEventHandler(Func fnc) {
-        return {__addMissionEventHandler_Impl<Type>::add(fnc), [type = Type](EHIdentifier& id) { funcMapMissionEH.erase(id); delScriptEH(type,id); }};
+        return {__addMissionEventHandler_Impl<Type>::add(std::move(fnc)), [type = Type](EHIdentifier& id) { eraseEHCallback(funcMapMissionEH, id); delScriptEH(type,id); }};
     }
 
 #pragma endregion
@@ -247,6 +441,19 @@ namespace intercept::client {
         gunner,
         cargo
     };
+
+    /// @private
+    template <>
+    struct eh_argument<get_in_position> {
+        static constexpr size_t width = 1;
+        static get_in_position decode(types::game_value_parameter args_, size_t index_) {
+            using namespace std::literals;
+            auto position = static_cast<types::r_string>(args_[index_]);
+            if (position == "gunner"sv) return get_in_position::gunner;
+            if (position == "cargo"sv) return get_in_position::cargo;
+            return get_in_position::driver;
+        }
+    };
 #define EH_Func_Args_Object_GetIn types::object vehicle, get_in_position position, types::object unit, types::rv_turret_path turret_path
 #define EH_Func_Args_Object_GetInMan types::object vehicle, get_in_position position, types::object unit, types::rv_turret_path turret_path
 #define EH_Func_Args_Object_GetOut types::object vehicle, get_in_position position, types::object unit, types::rv_turret_path turret_path
@@ -271,7 +478,7 @@ namespace intercept::client {
          direction(gv[7]),
          radius(gv[8]),
          surface(gv[9]),
-         direct(gv[19]) {}
+         direct(gv[10]) {}
      types::object target;
      types::object shooter;
      types::object bullet;
@@ -285,7 +492,42 @@ namespace intercept::client {
      bool direct;
  };
 
-#define EH_Func_Args_Object_HitPart std::vector<eventhandler_hit_part_type>;
+#define EH_Func_Args_Object_HitPart const std::vector<eventhandler_hit_part_type>& hits
+
+    /**
+     * @brief Decodes the hits of a HitPart event into a vector that is reused between events.
+     * @private
+     */
+    struct eh_hit_part_dispatcher {
+        template <typename Func>
+        static types::game_value invoke(Func& function_, types::game_value_parameter args_) {
+            static std::vector<eventhandler_hit_part_type> hits;
+            static bool in_use = false;
+            //A handler that causes another HitPart right away gets its own vector
+            if (in_use) {
+                std::vector<eventhandler_hit_part_type> nested_hits;
+                return dispatch(function_, args_, nested_hits);
+            }
+            struct use_guard {
+                use_guard() { in_use = true; }
+                ~use_guard() { in_use = false; }
+            } guard;
+            return dispatch(function_, args_, hits);
+        }
+
+    private:
+        template <typename Func>
+        static types::game_value dispatch(Func& function_, types::game_value_parameter args_, std::vector<eventhandler_hit_part_type>& hits_) {
+            struct clear_hits {
+                //Don't keep the hit objects alive until the next hit
+                ~clear_hits() { hits.clear(); }
+                std::vector<eventhandler_hit_part_type>& hits;
+            } clear{hits_};
+            for (auto& hit : args_.to_array()) hits_.emplace_back(hit);
+            function_(static_cast<const std::vector<eventhandler_hit_part_type>&>(hits_));
+            return {};
+        }
+    };
 #define EH_Func_Args_Object_Init types::object unit
 #define EH_Func_Args_Object_HandleIdentity types::object unit
 #define EH_Func_Args_Object_IncomingMissile types::object target, types::r_string ammo, types::object vehicle, types::object instigator
@@ -322,6 +564,15 @@ namespace intercept::client {
         Healing_With_Medikit,
         Recovered = 14
     };
+
+    /// @private
+    template <>
+    struct eh_argument<sound_played_origin> {
+        static constexpr size_t width = 1;
+        static sound_played_origin decode(types::game_value_parameter args_, size_t index_) {
+            return static_cast<sound_played_origin>(static_cast<int>(args_[index_]));
+        }
+    };
 #define EH_Func_Args_Object_SoundPlayed types::object unit, sound_played_origin soundCode
 #define EH_Func_Args_Object_Take types::object unit, types::object container, types::r_string item
 #define EH_Func_Args_Object_TaskSetAsCurrent types::object unit, types::task task_
@@ -461,26 +712,25 @@ namespace intercept::client {
 
     EHDEF_OBJECT(COMPILETIME_CHECK_ENUM_OBJECT)
     /// @private
-    intercept::types::game_value callEHHandler(eventhandlers_object ehType, intercept::types::game_value args, std::shared_ptr<std::function<void()>> func);
-    /// @private
     EHIdentifier addScriptEH(types::object obj, eventhandlers_object type);
     /// @private
     void delScriptEH(types::object obj, eventhandlers_object type, EHIdentifier& handle);
     /// @private
-    extern std::unordered_map<EHIdentifier, std::pair<eventhandlers_object, std::shared_ptr<std::function<void()>>>, EHIdentifier_hasher> funcMapObjectEH;
+    extern eh_callback_map funcMapObjectEH;
     /// @private
     template <eventhandlers_object Type>
     struct __addEventHandler_Impl;
 
-#define EH_Add_Object_definition(name, retVal, fncArg)                                                                                                            \
-    template <>                                                                                                                                                   \
-    struct __addEventHandler_Impl<eventhandlers_object::name> {                                                                                                   \
-        using fncType = std::function<retVal(fncArg)>;                                                                                                            \
-        [[nodiscard]] static EHIdentifier add(types::object obj, std::function<retVal(fncArg)> function) {                                                        \
-            auto ident = addScriptEH(obj, eventhandlers_object::name);                                                                                            \
-            funcMapObjectEH[ident] = {eventhandlers_object::name, std::make_shared<std::function<void()>>(*reinterpret_cast<std::function<void()>*>(&function))}; \
-            return ident;                                                                                                                                         \
-        }                                                                                                                                                         \
+#define EH_Add_Object_definition(name, retVal, fncArg)                                                                 \
+    template <>                                                                                                        \
+    struct __addEventHandler_Impl<eventhandlers_object::name> {                                                        \
+        using fncType = std::function<retVal(fncArg)>;                                                                 \
+        template <typename Func>                                                                                       \
+        [[nodiscard]] static EHIdentifier add(types::object obj, Func&& function) {                                    \
+            auto ident = addScriptEH(obj, eventhandlers_object::name);                                                 \
+            funcMapObjectEH[ident] = eh_callback::create<eh_dispatcher<retVal(fncArg)>>(std::forward<Func>(function)); \
+            return ident;                                                                                              \
+        }                                                                                                              \
     };
 
     EHDEF_OBJECT(EH_Add_Object_definition)
@@ -488,10 +738,11 @@ namespace intercept::client {
     /// @private
     template <>
     struct __addEventHandler_Impl<eventhandlers_object::HitPart> {
-        using fncType = std::function<void(std::vector<eventhandler_hit_part_type>)>;
-        [[nodiscard]] static EHIdentifier add(types::object obj, std::function<void(std::vector<eventhandler_hit_part_type>)> function) {
+        using fncType = std::function<void(EH_Func_Args_Object_HitPart)>;
+        template <typename Func>
+        [[nodiscard]] static EHIdentifier add(types::object obj, Func&& function) {
             auto ident = addScriptEH(obj, eventhandlers_object::HitPart);
-            funcMapObjectEH[ident] = { eventhandlers_object::HitPart, std::make_shared<std::function<void()>>(*reinterpret_cast<std::function<void()>*>(&function)) };
+            funcMapObjectEH[ident] = eh_callback::create<eh_hit_part_dispatcher>(std::forward<Func>(function));
             return ident;
         }
     };
@@ -508,7 +759,7 @@ namespace intercept::client {
     */
     template <eventhandlers_object Type, typename Func = typename __addEventHandler_Impl<Type>::fncType>
     [[nodiscard]] EHIdentifierHandle addEventHandler(types::object obj, Func fnc) {
-        return { __addEventHandler_Impl<Type>::add(obj, fnc), [obj,type = Type](EHIdentifier& id) { funcMapObjectEH.erase(id); delScriptEH(obj,type,id); } };
+        return { __addEventHandler_Impl<Type>::add(obj, std::move(fnc)), [obj,type = Type](EHIdentifier& id) { eraseEHCallback(funcMapObjectEH, id); delScriptEH(obj,type,id); } };
     }
 
 #pragma endregion
@@ -551,27 +802,26 @@ namespace intercept::client {
 
     EHDEF_CTRL(COMPILETIME_CHECK_ENUM_CTRL)
 
-    /// @private
-    intercept::types::game_value callEHHandler(eventhandlers_ctrl ehType, intercept::types::game_value args, std::shared_ptr<std::function<void()>> func);
     /// @private
     EHIdentifier addScriptEH(types::control ctrl, eventhandlers_ctrl type);
     /// @private
     void delScriptEH(types::control ctrl, eventhandlers_ctrl type, EHIdentifier& handle);
     /// @private
-    extern std::unordered_map<EHIdentifier, std::pair<eventhandlers_ctrl, std::shared_ptr<std::function<void()>>>, EHIdentifier_hasher> funcMapCtrlEH;
+    extern eh_callback_map funcMapCtrlEH;
     /// @private
     template <eventhandlers_ctrl Type>
     struct __ctrlAddEventHandler_Impl;
 
-#define EH_Add_Ctrl_definition(name, retVal, fncArg)                                                                                                          \
-    template <>                                                                                                                                               \
-    struct __ctrlAddEventHandler_Impl<eventhandlers_ctrl::name> {                                                                                             \
-        using fncType = std::function<retVal(fncArg)>;                                                                                                        \
-        [[nodiscard]] static EHIdentifier add(types::control ctrl, std::function<retVal(fncArg)> function) {                                                  \
-            auto ident = addScriptEH(ctrl, eventhandlers_ctrl::name);                                                                                         \
-            funcMapCtrlEH[ident] = {eventhandlers_ctrl::name, std::make_shared<std::function<void()>>(*reinterpret_cast<std::function<void()>*>(&function))}; \
-            return ident;                                                                                                                                     \
-        }                                                                                                                                                     \
+#define EH_Add_Ctrl_definition(name, retVal, fncArg)                                                                 \
+    template <>                                                                                                      \
+    struct __ctrlAddEventHandler_Impl<eventhandlers_ctrl::name> {                                                    \
+        using fncType = std::function<retVal(fncArg)>;                                                               \
+        template <typename Func>                                                                                     \
+        [[nodiscard]] static EHIdentifier add(types::control ctrl, Func&& function) {                                \
+            auto ident = addScriptEH(ctrl, eventhandlers_ctrl::name);                                                \
+            funcMapCtrlEH[ident] = eh_callback::create<eh_dispatcher<retVal(fncArg)>>(std::forward<Func>(function)); \
+            return ident;                                                                                            \
+        }                                                                                                            \
     };
 
     EHDEF_CTRL(EH_Add_Ctrl_definition)
@@ -586,7 +836,7 @@ namespace intercept::client {
     */
     template <eventhandlers_ctrl Type, typename Func = typename __ctrlAddEventHandler_Impl<Type>::fncType>
     [[nodiscard]] EHIdentifierHandle ctrlAddEventHandler(types::control ctrl, Func fnc) {
-        return {__ctrlAddEventHandler_Impl<Type>::add(ctrl, fnc), [ctrl,type = Type](EHIdentifier& id) { funcMapCtrlEH.erase(id); delScriptEH(ctrl,type,id); }};
+        return {__ctrlAddEventHandler_Impl<Type>::add(ctrl, std::move(fnc)), [ctrl,type = Type](EHIdentifier& id) { eraseEHCallback(funcMapCtrlEH, id); delScriptEH(ctrl,type,id); }};
     }
 #pragma endregion
 
@@ -616,27 +866,26 @@ namespace intercept::client {
 
     EHDEF_MP(COMPILETIME_CHECK_ENUM_MP)
 
-    /// @private
-    intercept::types::game_value callEHHandler(eventhandlers_mp ehType, intercept::types::game_value args, std::shared_ptr<std::function<void()>> func);
     /// @private
     EHIdentifier addScriptEH(types::object unit, eventhandlers_mp type);
     /// @private
     void delScriptEH(types::object unit, eventhandlers_mp type, EHIdentifier& handle);
     /// @private
-    extern std::unordered_map<EHIdentifier, std::pair<eventhandlers_mp, std::shared_ptr<std::function<void()>>>, EHIdentifier_hasher> funcMapMPEH;
+    extern eh_callback_map funcMapMPEH;
     /// @private
     template <eventhandlers_mp Type>
     struct __addMPEventHandler_Impl;
 
-#define EH_Add_MP_definition(name, retVal, fncArg)                                                                                                          \
-    template <>                                                                                                                                               \
-    struct __addMPEventHandler_Impl<eventhandlers_mp::name> {                                                                                             \
-        using fncType = std::function<retVal(fncArg)>;                                                                                                        \
-        [[nodiscard]] static EHIdentifier add(types::object unit, std::function<retVal(fncArg)> function) {                                                  \
-            auto ident = addScriptEH(unit, eventhandlers_mp::name);                                                                                         \
-            funcMapMPEH[ident] = {eventhandlers_mp::name, std::make_shared<std::function<void()>>(*reinterpret_cast<std::function<void()>*>(&function))}; \
-            return ident;                                                                                                                                     \
-        }                                                                                                                                                     \
+#define EH_Add_MP_definition(name, retVal, fncArg)                                                                 \
+    template <>                                                                                                    \
+    struct __addMPEventHandler_Impl<eventhandlers_mp::name> {                                                      \
+        using fncType = std::function<retVal(fncArg)>;                                                             \
+        template <typename Func>                                                                                   \
+        [[nodiscard]] static EHIdentifier add(types::object unit, Func&& function) {                               \
+            auto ident = addScriptEH(unit, eventhandlers_mp::name);                                                \
+            funcMapMPEH[ident] = eh_callback::create<eh_dispatcher<retVal(fncArg)>>(std::forward<Func>(function)); \
+            return ident;                                                                                          \
+        }                                                                                                          \
     };
 
     EHDEF_MP(EH_Add_MP_definition)
@@ -652,7 +901,7 @@ namespace intercept::client {
     */
     template <eventhandlers_mp Type, typename Func = typename __addMPEventHandler_Impl<Type>::fncType>
     [[nodiscard]] EHIdentifierHandle addMPEventHandler(types::object unit, Func fnc) {
-        return { __addMPEventHandler_Impl<Type>::add(unit, fnc), [unit,type = Type](EHIdentifier& id) { funcMapMPEH.erase(id); delScriptEH(unit,type,id); } };
+        return { __addMPEventHandler_Impl<Type>::add(unit, std::move(fnc)), [unit,type = Type](EHIdentifier& id) { eraseEHCallback(funcMapMPEH, id); delScriptEH(unit,type,id); } };
     }
 #pragma endregion
 
@@ -694,27 +943,26 @@ namespace intercept::client {
 
     EHDEF_Display(COMPILETIME_CHECK_ENUM_Display)
 
-    /// @private
-    intercept::types::game_value callEHHandler(eventhandlers_display ehType, intercept::types::game_value args, std::shared_ptr<std::function<void()>> func);
     /// @private
     EHIdentifier addScriptEH(types::display disp, eventhandlers_display type);
     /// @private
     void delScriptEH(types::display disp, eventhandlers_display type, EHIdentifier& handle);
     /// @private
-    extern std::unordered_map<EHIdentifier, std::pair<eventhandlers_display, std::shared_ptr<std::function<void()>>>, EHIdentifier_hasher> funcMapDisplayEH;
+    extern eh_callback_map funcMapDisplayEH;
     /// @private
     template <eventhandlers_display Type>
     struct __displayAddEventHandler_Impl;
 
-#define EH_Add_Display_definition(name, retVal, fncArg)                                                                                                          \
-    template <>                                                                                                                                               \
-    struct __displayAddEventHandler_Impl<eventhandlers_display::name> {                                                                                             \
-        using fncType = std::function<retVal(fncArg)>;                                                                                                        \
-        [[nodiscard]] static EHIdentifier add(types::display disp, std::function<retVal(fncArg)> function) {                                                  \
-            auto ident = addScriptEH(disp, eventhandlers_display::name);                                                                                         \
-            funcMapDisplayEH[ident] = {eventhandlers_display::name, std::make_shared<std::function<void()>>(*reinterpret_cast<std::function<void()>*>(&function))}; \
-            return ident;                                                                                                                                     \
-        }                                                                                                                                                     \
+#define EH_Add_Display_definition(name, retVal, fncArg)                                                                 \
+    template <>                                                                                                         \
+    struct __displayAddEventHandler_Impl<eventhandlers_display::name> {                                                 \
+        using fncType = std::function<retVal(fncArg)>;                                                                  \
+        template <typename Func>                                                                                        \
+        [[nodiscard]] static EHIdentifier add(types::display disp, Func&& function) {                                   \
+            auto ident = addScriptEH(disp, eventhandlers_display::name);                                                \
+            funcMapDisplayEH[ident] = eh_callback::create<eh_dispatcher<retVal(fncArg)>>(std::forward<Func>(function)); \
+            return ident;                                                                                               \
+        }                                                                                                               \
     };
 
     EHDEF_Display(EH_Add_Display_definition)
@@ -730,14 +978,14 @@ namespace intercept::client {
     */
     template <eventhandlers_display Type, typename Func = typename __displayAddEventHandler_Impl<Type>::fncType>
     [[nodiscard]] EHIdentifierHandle displayAddEventHandler(types::display disp, Func fnc) {
-        return { __displayAddEventHandler_Impl<Type>::add(disp, fnc), [disp,type = Type](EHIdentifier& id) { funcMapDisplayEH.erase(id); delScriptEH(disp,type,id); } };
+        return { __displayAddEventHandler_Impl<Type>::add(disp, std::move(fnc)), [disp,type = Type](EHIdentifier& id) { eraseEHCallback(funcMapDisplayEH, id); delScriptEH(disp,type,id); } };
     }
 #pragma endregion
 
 #pragma region Custom Callback
 
     /// @private
-    extern std::unordered_map<EHIdentifier, std::shared_ptr<std::function<types::game_value(types::game_value_parameter)>>, EHIdentifier_hasher> customCallbackMap;
+    extern eh_callback_map customCallbackMap;
 
 
     /**
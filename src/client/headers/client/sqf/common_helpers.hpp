@@ -63,6 +63,11 @@ namespace intercept {
 
             object __object_unary_object(unary_function fnc_, const object &obj_);
 
+            /** Batched helpers, calls fnc_ for every object under a single invoker lock **/
+            void __vector3_unary_objects(unary_function fnc_, const std::vector<object> &objects_, std::vector<vector3> &results_);
+            void __number_unary_objects(unary_function fnc_, const std::vector<object> &objects_, std::vector<float> &results_);
+            void __bool_unary_objects(unary_function fnc_, const std::vector<object> &objects_, std::vector<bool> &results_);
+
 
             template <class T>
             typename std::enable_if<std::is_convertible<game_value, T>::value, std::vector<T>>::type
@@ -116,6 +116,8 @@ namespace intercept {
 
         std::vector<config> config_hierarchy(const config &config_entry_);
         sqf_return_string config_name(const config &config_entry_);
+        ///Same as config_name but keeps the engine's string instead of copying it, it converts to std::string_view for free
+        r_string config_name_raw(const config &config_entry_);
         std::vector<config> config_properties(const config &config_entry, sqf_string_const_ref condition_ = "true", bool inherit = true);
         sqf_return_string config_source_mod(const config &config_entry_);
         sqf_return_string_list config_source_mod_list(const config &config_entry_);
@@ -124,6 +126,8 @@ namespace intercept {
         config get_mission_config(sqf_string_const_ref value_);
         float get_number(const config &config_entry_);
         sqf_return_string get_text(const config &config_entry_);
+        ///Same as get_text but keeps the engine's string instead of copying it, it converts to std::string_view for free
+        r_string get_text_raw(const config &config_entry_);
         config inherits_from(const config &config_entry_);
         bool is_array(const config &config_entry_);
         bool is_class(const config &config_entry_);
@@ -175,5 +179,7 @@ namespace intercept {
         }
         std::vector<game_value> mod_params(sqf_string_const_ref mod_class_, mod_params_options options_);
         sqf_return_string type_of(const object &value_);
+        ///Same as type_of but keeps the engine's string instead of copying it, it converts to std::string_view for free
+        r_string type_of_raw(const object &value_);
     }  // namespace sqf
 }  // namespace intercept
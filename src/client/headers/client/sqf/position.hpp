@@ -38,6 +38,23 @@ namespace intercept {
         vector3 get_pos_atl_visual(const object &obj_);
         vector3 aim_pos(const object &obj_);
 
+        /*!
+        @name Batched position queries
+        @brief Query many objects at once, results_[i] belongs to objects_[i].
+
+        These take the invoker lock once for all objects instead of once per
+        call. results_ is resized to match objects_, pass the same buffer every
+        frame to reuse its memory.
+        */
+        //!@{
+        void get_pos(const std::vector<object> &objects_, std::vector<vector3> &results_);
+        void get_pos_asl(const std::vector<object> &objects_, std::vector<vector3> &results_);
+        void get_pos_atl(const std::vector<object> &objects_, std::vector<vector3> &results_);
+        void get_pos_world(const std::vector<object> &objects_, std::vector<vector3> &results_);
+        void velocity(const std::vector<object> &objects_, std::vector<vector3> &results_);
+        void get_dir(const std::vector<object> &objects_, std::vector<float> &results_);
+        //!@}
+
         vector3 eye_pos(const object &object_);
         vector3 eye_direction(const object &unit_);
 
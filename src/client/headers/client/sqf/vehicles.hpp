@@ -96,6 +96,8 @@ namespace intercept {
 
         std::vector<rv_turret_path> all_turrets(const object &vehicle_);
         bool alive(const object &obj_);
+        ///Batched alive, takes the invoker lock once. results_[i] belongs to objects_[i].
+        void alive(const std::vector<object> &objects_, std::vector<bool> &results_);
         object assigned_commander(const object &veh_);
         object assigned_driver(const object &veh_);
         object assigned_gunner(const object &veh_);
@@ -103,6 +105,8 @@ namespace intercept {
         object commander(const object &veh_);
         group create_vehicle_crew(const object &veh_);
         float damage(const object &object_);
+        ///Batched damage, takes the invoker lock once. results_[i] belongs to objects_[i].
+        void damage(const std::vector<object> &objects_, std::vector<float> &results_);
         object driver(const object &value_);
         object effective_commander(const object &value_);
 
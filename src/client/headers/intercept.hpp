@@ -22,6 +22,8 @@ namespace intercept {
         DLLEXPORT void CDECL on_frame();
         DLLEXPORT void CDECL on_signal(std::string &signal_name_, game_value& value1_);  //#TODO no C ABI here! use r_string
         DLLEXPORT void CDECL on_interface_unload(r_string name_);
+        /// @brief The plugin that exports the interface was reloaded and registered it again, request it anew. Optional.
+        DLLEXPORT void CDECL on_interface_reload(r_string name_);
         DLLEXPORT void CDECL register_interfaces();
         DLLEXPORT void CDECL handle_unload();
         DLLEXPORT bool CDECL is_signed();
@@ -416,11 +416,25 @@ class internal_object : public game_value {
      * \brief A Deallocation Threadsafe variant of game_value.
      * \description When going out of scope it doesn't deallocate the data immediately but instead stores it
      * till game_value_threadsafe::garbage_collect() is called.
+     * Every thread keeps its own garbage, so threads discarding values never wait on each other. Call
+     * garbage_collect() once per frame from the main thread, for example in on_frame, it releases the garbage
+     * of all threads at once.
      */
     class game_value_threadsafe : public game_value {
     public:
+        struct garbage_stats {
+            size_t pending;         ///< Values waiting for the next garbage_collect()
+            size_t peak_pending;    ///< Most values a single garbage_collect() ever had to release
+            uint64_t collected;     ///< Values released by garbage_collect() so far
+            size_t threads;         ///< Running threads that discarded values at some point
+        };
 
         static void garbage_collect();
+        /**
+         * \brief Counters of the deferred releases. A pending count that keeps growing means garbage_collect()
+         * isn't called, or not often enough.
+         */
+        static garbage_stats garbage_statistics();
 
         ~game_value_threadsafe();
         game_value_threadsafe(const game_value& copy) : game_value(copy) {}
@@ -471,6 +485,72 @@ class internal_object : public game_value {
         static void discard(ref<game_data> && data);
     };
 
+    /**
+     * \brief Builds SQF argument arrays, reusing the engine objects of the previous build.
+     * \description Every build starts with begin() and ends with get(). If nothing else holds a reference to
+     * the array or one of its elements anymore (the engine usually doesn't keep arguments), those are overwritten
+     * in place instead of being freed and allocated again. Calling a command with the same argument shape
+     * repeatedly therefore doesn't allocate after the first call.
+     * Elements that are still referenced elsewhere are replaced, never modified.
+     * A builder is not threadsafe. SQF commands are only called from the main thread or under the invoker lock
+     * though, so a static builder per command wrapper is fine.
+     * Static builders should call release() once the command returned, so they don't keep the caller's objects,
+     * strings or arrays alive until the next call.
+     */
+    class game_value_builder {
+    public:
+        explicit game_value_builder(size_t reserve_ = 8) : _reserve(reserve_) {}
+
+        /**
+         * \brief Starts a new array.
+         */
+        game_value_builder& begin();
+
+        game_value_builder& add(float val_);
+        game_value_builder& add(int val_) { return add(static_cast<float>(val_)); }
+        game_value_builder& add(bool val_);
+        game_value_builder& add(const vector3& vec_);
+        game_value_builder& add(const vector2& vec_);
+        game_value_builder& add(const game_value& val_);
+        game_value_builder& add(game_value&& val_);
+        game_value_builder& add_nil();
+
+        /**
+         * \brief Adds the value, or nil if it is empty.
+         */
+        template <class Type>
+        game_value_builder& add(const std::optional<Type>& val_) {
+            if (val_) return add(*val_);
+            return add_nil();
+        }
+
+        /**
+         * \brief Finishes the array.
+         * \return The array, valid until the next call to begin().
+         */
+        const game_value& get();
+
+        /**
+         * \brief Drops every element that can't be overwritten in place, numbers, bools and vectors are kept.
+         * \description If something else still holds the array, the builder drops it entirely.
+         */
+        void release();
+
+        /**
+         * \brief Number of engine objects this builder had to create, for diagnostics.
+         */
+        size_t created_count() const noexcept { return _created; }
+
+    private:
+        game_value& next_slot();
+        bool set_numbers(game_value& slot_, const float* values_, size_t count_);
+
+        game_value_static _array;  //Doesn't free on game exit, builders are usually static
+        size_t _reserve;
+        size_t _cursor{0};
+        size_t _created{0};
+    };
+
 }
 
 //custom conversion from std::string& to const std::string& inside reference_wrapper
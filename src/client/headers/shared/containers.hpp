@@ -4,7 +4,11 @@
 #include <algorithm>
 #include <optional>
 #include <cstring>
+#include <new>
+#include <iterator>
+#include <type_traits>
 #include <vector>
+#include "swiss_table.hpp"
 
 #pragma push_macro("min")
 #pragma push_macro("max")
@@ -748,15 +752,21 @@ namespace intercept::types {
             }
         }
         explicit operator const char*() const noexcept { return data(); }
-        operator std::string_view() const noexcept { return std::string_view(data()); }
+        operator std::string_view() const noexcept { return std::string_view(data(), length()); }
         //explicit operator std::string() const { return std::string(data()); } //non explicit will break string_view operator because std::string operator because it becomes ambiguous
-        ///This calls strlen so O(N)
+        /*!
+        @brief O(1) for strings created by this SDK, they store their length behind the terminator.
+
+        Buffers that come from the engine fall back to strlen, they can have null chars or garbage after the terminator.
+        */
         size_t length() const noexcept {
             if (!_ref) return 0;
+            size_t tagged_length;
+            if (read_length_tag(_ref.get(), tagged_length)) return tagged_length;
             return strlen(_ref->data());
         }
 
-        ///This calls strlen so O(N)
+        ///Same as length()
         size_t size() const noexcept {
             return length();
         }
@@ -781,13 +791,14 @@ namespace intercept::types {
         ///== is case insensitive just like scripting
         bool operator==(std::string_view other_) const {
             if (empty()) return other_.empty();
-            if (other_.length() > _ref->size()) return false;  //There is more data than we can even have
+            const auto my_length = length();
+            if (my_length != other_.length()) return false;
 
-            return std::equal(other_.cbegin(), other_.cend(),
-                              begin(), end(),
-                              [](unsigned char l, unsigned char r) {
-                                  return l == r || tolower(l) == tolower(r);
-                              });
+            const char* str = data();
+            for (size_t i = 0; i < my_length; ++i) {
+                if (str[i] != other_[i] && fold_case(str[i]) != fold_case(other_[i])) return false;
+            }
+            return true;
         }
 
         ///== is case insensitive just like scripting
@@ -878,28 +889,35 @@ namespace intercept::types {
         void clear() {
             _ref = nullptr;
         }
+        ///Case insensitive, so strings that compare equal hash equal
         size_t hash() const noexcept {
-            return std::hash<std::string_view>()(std::string_view(data(), _ref ? _ref->size() : 0u));
+            uint64_t hash = 14695981039346656037ull;  //FNV-1a
+            const char* str = data();
+            for (size_t i = 0, my_length = length(); i < my_length; ++i) {
+                hash ^= fold_case(str[i]);
+                hash *= 1099511628211ull;
+            }
+            return static_cast<size_t>(hash);
         }
 
         r_string append(std::string_view right_) const {
+            right_ = right_.substr(0, right_.find('\0'));
             const auto my_length = length();
-            auto new_data = create(my_length + right_.length() + 1);  //Space for terminating nullchar
+            auto new_data = create(my_length + right_.length());
+            if (!new_data) return r_string();
 
             std::copy_n(begin(), my_length, new_data->begin());
             std::copy_n(right_.data(), right_.length(), new_data->begin() + my_length);
-
-            new_data->data()[my_length + right_.length()] = 0;
             return r_string(new_data);
         }
         r_string& append_modify(std::string_view right_) {
+            right_ = right_.substr(0, right_.find('\0'));
             const auto my_length = length();
-            auto newData = create(my_length + right_.length() + 1);  //Space for terminating nullchar
+            auto newData = create(my_length + right_.length());
+            if (!newData) return *this;
 
             std::copy_n(data(), my_length, newData->begin());
             std::copy_n(right_.data(), right_.length(), newData->begin() + my_length);
-
-            newData->data()[my_length + right_.length()] = 0;
             _ref = newData;
             return *this;
         }
@@ -908,12 +926,11 @@ namespace intercept::types {
         }
         friend r_string operator+(const char* left, const r_string& right_) {
             const auto my_length = strlen(left);
-            auto new_data = create(my_length + right_.length() + 1);  //Space for terminating nullchar
+            auto new_data = create(my_length + right_.length());
+            if (!new_data) return r_string();
 
             std::copy_n(left, my_length, new_data->begin());
             std::copy_n(right_.data(), right_.length(), new_data->begin() + my_length);
-
-            new_data->data()[my_length + right_.length()] = 0;
             return r_string(new_data);
         }
         r_string& operator+=(const std::string_view right_) {
@@ -923,7 +940,8 @@ namespace intercept::types {
             if (!_ref) return *this;
             make_mutable();
 
-            std::transform(_ref->begin(), _ref->end(), _ref->begin(), ::tolower);
+            //Only the characters, the buffer can continue with the length tag
+            std::transform(_ref->begin(), _ref->begin() + length(), _ref->begin(), ::tolower);
 
             return *this;
         }
@@ -935,7 +953,6 @@ namespace intercept::types {
         }
         ///Be careful! This returns nullptr on empty string
         compact_array<char>::const_iterator end() const noexcept {
-            //#TODO could use sentinel here, would spare us the strlen call.
             if (_ref)
                 return _ref->begin() + length(); //Cannot use compact array end, as that is the whole buffer including null chars or end garbage
             return {};
@@ -949,22 +966,52 @@ namespace intercept::types {
     private:
         ref<compact_array<char>> _ref;
 
-        static compact_array<char>* create(const char* str, const size_t len_) {
+        //ASCII only, the same as tolower in the C locale but without the locale lookup
+        static constexpr unsigned char fold_case(char char_) noexcept {
+            const auto c = static_cast<unsigned char>(char_);
+            return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c | 0x20) : c;
+        }
+
+        /*!
+        @brief Written after the terminator of every string this SDK creates: the length, and the length xor length_tag_magic.
+        @details Nobody reads past the terminator, the engine already has to deal with garbage there.
+        */
+        static constexpr size_t length_tag_size = 2 * sizeof(uint32_t);
+        static constexpr uint32_t length_tag_magic = 0x4C525453;
+
+        static void write_length_tag(compact_array<char>* string_, const size_t len_) noexcept {
+            const uint32_t tag[2] = {static_cast<uint32_t>(len_), static_cast<uint32_t>(len_) ^ length_tag_magic};
+            //launder, the compiler otherwise takes the one element _data for the size of the buffer
+            std::memcpy(std::launder(string_->data()) + len_ + 1, tag, length_tag_size);
+        }
+
+        static bool read_length_tag(const compact_array<char>* string_, size_t& len_) noexcept {
+            if (string_->size() < length_tag_size + 1) return false;
+            const auto len = string_->size() - length_tag_size - 1;
+            uint32_t tag[2];
+            std::memcpy(tag, string_->data() + len + 1, length_tag_size);
+            if (tag[0] != len || tag[1] != (tag[0] ^ length_tag_magic) || string_->data()[len] != '\0') return false;
+            len_ = len;
+            return true;
+        }
+
+        static compact_array<char>* create(const char* str, size_t len_) {
             if (len_ == 0 || *str == 0) return nullptr;
-            compact_array<char>* string = compact_array<char>::create(len_ + 1);
-#if __GNUC__
+            //Everyone else sees a C string, so the tag may not count anything after an embedded null
+            if (auto null_char = static_cast<const char*>(std::memchr(str, 0, len_))) len_ = null_char - str;
+            compact_array<char>* string = create(len_);
             std::copy_n(str, len_, string->data());
-#else
-            strncpy_s(string->data(), string->size(), str, len_);  //#TODO better use memcpy? does strncpy_s check for null chars? we don't want that
-#endif
-            string->data()[len_] = 0;
             return string;
         }
 
+        ///Room for len_ characters, terminated and tagged with len_. The characters are left to the caller.
         static compact_array<char>* create(const size_t len_) {
             if (len_ == 0) return nullptr;
-            compact_array<char>* string = compact_array<char>::create(len_ + 1);
-            string->data()[0] = 0;
+            compact_array<char>* string = compact_array<char>::create(len_ + 1 + length_tag_size);
+            char* const data = std::launder(string->data());
+            data[0] = 0;
+            data[len_] = 0;
+            write_length_tag(string, len_);
             return string;
         }
 
@@ -1220,7 +1267,31 @@ namespace intercept::types {
         }
     };
 
-    template <class Type, class Allocator = rv_allocator<Type>, size_t growthFactor = 32>
+    /**
+    * @brief Growth policies for auto_array.
+    * @description next_capacity picks the new capacity when an auto_array with capacity_ has to hold required_
+    * elements. step_ is the auto_arrays growthFactor, the least it grows by.
+    * Growing linearly makes filling an array one element at a time quadratic in copies and reallocations, the
+    * geometric policies make it amortized constant.
+    */
+    struct auto_array_linear_growth {
+        static constexpr size_t next_capacity(size_t capacity_, size_t required_, size_t step_) noexcept {
+            return (std::max)(required_, capacity_ + step_);
+        }
+    };
+
+    template <size_t Numerator, size_t Denominator>
+    struct auto_array_geometric_growth {
+        static_assert(Numerator > Denominator, "auto_array_geometric_growth has to grow");
+        static constexpr size_t next_capacity(size_t capacity_, size_t required_, size_t step_) noexcept {
+            return (std::max)(required_, capacity_ + (std::max)(step_, capacity_ * (Numerator - Denominator) / Denominator));
+        }
+    };
+
+    using auto_array_growth_1_5x = auto_array_geometric_growth<3, 2>;
+    using auto_array_growth_2x = auto_array_geometric_growth<2, 1>;
+
+    template <class Type, class Allocator = rv_allocator<Type>, size_t growthFactor = 32, class GrowthPolicy = auto_array_growth_1_5x>
     class
 #ifdef _MSC_VER
         __declspec(empty_bases)
@@ -1268,8 +1339,16 @@ namespace intercept::types {
         }
 
         void grow(const size_t n_) {
-#undef max
-            reallocate(_maxItems + std::max(n_, growthFactor));
+            reallocate(GrowthPolicy::next_capacity(static_cast<size_t>(_maxItems), _maxItems + n_, growthFactor));
+        }
+
+        /**
+        * @brief Grows by the growth policy if the capacity is less than required_
+        */
+        void ensure_capacity(const size_t required_) {
+            if (_maxItems < static_cast<int>(required_)) {
+                grow(required_ - _maxItems);
+            }
         }
 
     public:
@@ -1287,10 +1366,10 @@ namespace intercept::types {
         auto_array(_InIt first_, _InIt last_) : rv_array<Type>(), _maxItems(0) {
             insert(end(), first_, last_);
         }
-        auto_array(const auto_array<Type>& copy_) : rv_array<Type>(), _maxItems(0) {
+        auto_array(const auto_array& copy_) : rv_array<Type>(), Allocator(), _maxItems(0) {
             insert(end(), copy_.begin(), copy_.end());
         }
-        auto_array(auto_array<Type>&& move_) noexcept : rv_array<Type>(std::move(move_)), _maxItems(move_._maxItems) {
+        auto_array(auto_array&& move_) noexcept : rv_array<Type>(std::move(move_)), _maxItems(move_._maxItems) {
             move_._maxItems = 0;
         }
         ~auto_array() {
@@ -1304,6 +1383,8 @@ namespace intercept::types {
             resize(base::_n);
         }
         auto_array& operator=(auto_array&& move_) noexcept {
+            if (this == &move_) return *this;
+            clear();
             base::_n = move_._n;
             _maxItems = move_._maxItems;
             base::_data = move_._data;
@@ -1314,10 +1395,9 @@ namespace intercept::types {
         }
 
         auto_array& operator=(const auto_array& copy_) {
-            if (copy_._n) {
-                clear();
-                insert(base::end(), copy_.begin(), copy_.end());
-            }
+            if (this == &copy_) return *this;
+            clear();
+            if (copy_._n) insert(base::end(), copy_.begin(), copy_.end());
             return *this;
         }
 
@@ -1329,11 +1409,14 @@ namespace intercept::types {
                 for (int i = static_cast<int>(n_); i < base::_n; i++) {
                     (*this)[i].~Type();
                 }
+                //Else reallocate would see too many elements and shrink through resize again
+                base::_n = static_cast<int>(n_);
             }
             if (n_ == 0 && base::_data) {
                 Allocator::deallocate(rv_array<Type>::_data);
                 base::_n = 0;
                 rv_array<Type>::_data = nullptr;
+                _maxItems = 0;
                 return;
             }
             reallocate(n_);
@@ -1348,12 +1431,49 @@ namespace intercept::types {
 
         /**
         * @brief Makes sure the capacity is big enough to contain res_ elements
+        * @description Allocates exactly res_ elements if it has to grow. The allocator gets to reallocate in place
+        * first, so reserving on an engine owned array doesn't have to copy it.
         * @param res_ new minimum buffer size
         */
         void reserve(const size_t res_) {
             if (_maxItems < static_cast<int>(res_)) {
-                grow(res_ - _maxItems);
+                reallocate(res_);
+            }
+        }
+
+        /**
+        * @brief Copies or moves all elements of range_ to the end of the array
+        * @description Ranges that know their size grow the array at most once.
+        * @param range_ the values to append, moved from if range_ is an rvalue
+        * @return A iterator pointing to the first appended value
+        */
+        template <class Range>
+        iterator append_range(Range&& range_) {
+            if constexpr (std::is_rvalue_reference_v<Range&&>)
+                return append_range(std::make_move_iterator(std::begin(range_)), std::make_move_iterator(std::end(range_)));
+            else
+                return append_range(std::begin(range_), std::end(range_));
+        }
+
+        /**
+        * @brief Copies all values from first_ to last_ to the end of the array
+        * @return A iterator pointing to the first appended value
+        */
+        template <class _InIt>
+        iterator append_range(_InIt first_, _InIt last_) {
+            const auto firstIndex = base::_n;
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>) {
+                ensure_capacity(base::_n + static_cast<size_t>(std::distance(first_, last_)));
+                auto index = base::_n;
+                for (; first_ != last_; ++first_) {
+                    ::new (base::_data + index) Type(*first_);
+                    ++index;
+                }
+                base::_n = index;
+            } else {
+                for (; first_ != last_; ++first_) emplace_back(*first_);
             }
+            return base::begin() + firstIndex;
         }
 
         /**
@@ -1420,11 +1540,9 @@ namespace intercept::types {
         //    memmove_s(&(*this)[index], (base::_n - index) * sizeof(Type), &(*this)[index + 1], (base::_n - index - 1) * sizeof(Type));
         //}
         void erase(const_iterator element_) {
-            if (element_ < base::begin() || element_ > base::end()) throw std::runtime_error("Invalid Iterator");
+            if (element_ < base::begin() || element_ >= base::end()) throw std::runtime_error("Invalid Iterator");
             const size_t index = std::distance(base::cbegin(), element_);
-            if (static_cast<int>(index) > base::_n) return;
-            auto&& item = (*this)[index];
-            item.~Type();
+            (*this)[index].~Type();
 #ifdef __GNUC__
             memmove(&(*this)[index], &(*this)[index + 1], (base::_n - index - 1) * sizeof(Type));
 #else
@@ -1435,29 +1553,31 @@ namespace intercept::types {
 
         void erase(const_iterator first_, const_iterator last_) {
             if (first_ > last_ || first_ < base::begin() || last_ > base::end()) throw std::runtime_error("Invalid Iterator");
+            //Also covers an empty array, which has no data to take indices from
+            if (first_ == last_) return;
             const size_t firstIndex = std::distance(base::cbegin(), first_);
             const size_t lastIndex = std::distance(base::cbegin(), last_);
             const size_t range = std::distance(first_, last_);
 
             for (size_t index = firstIndex; index < lastIndex; ++index) {
-                auto item = (*this)[index];
-                item.~Type();
+                (*this)[index].~Type();
             }
+            //last_ is one past the last erased element, everything from there on moves down
             if (last_ != end()) {
 #ifdef __GNUC__
-                memmove(&(*this)[firstIndex], &(*this)[lastIndex + 1], (base::_n - lastIndex - 1) * sizeof(Type));
+                memmove(&(*this)[firstIndex], &(*this)[lastIndex], (base::_n - lastIndex) * sizeof(Type));
 #else
-                memmove_s(&(*this)[firstIndex], (base::_n - firstIndex) * sizeof(Type), &(*this)[lastIndex + 1], (base::_n - lastIndex - 1) * sizeof(Type));
+                memmove_s(&(*this)[firstIndex], (base::_n - firstIndex) * sizeof(Type), &(*this)[lastIndex], (base::_n - lastIndex) * sizeof(Type));
 #endif
             }
-            base::_n -= range;
+            base::_n -= static_cast<int>(range);
         }
 
         void erase(const uint32_t index_, const uint32_t count_ = 1) {
             if (count_ == 1)
                 erase(begin() + index_);
             else if (count_ > 1)
-                erase(begin() + index_, begin() + index_ + (count_ - 1));
+                erase(begin() + index_, begin() + index_ + count_);
         }
 
         /**
@@ -1471,7 +1591,7 @@ namespace intercept::types {
             const size_t insertOffset = std::distance(base::begin(), _where);
             const size_t previousEnd = static_cast<size_t>(base::_n);
             const size_t oldSize = base::count();
-            reserve(oldSize + 1);
+            ensure_capacity(oldSize + 1);
 
             //emplace_back(_value);
             //custom inlined version of emplace_back. No capacity checks and only incrementing _n once.
@@ -1497,7 +1617,7 @@ namespace intercept::types {
             const size_t previousEnd = static_cast<size_t>(base::_n);
             const size_t oldSize = base::count();
             const size_t insertedSize = std::distance(_first, _last);
-            reserve(oldSize + insertedSize);
+            ensure_capacity(oldSize + insertedSize);
 
             auto index = base::_n;
             for (; _first != _last; ++_first) {
@@ -1524,8 +1644,12 @@ namespace intercept::types {
         }
 
         void clear() {
-            if (base::_data)
+            if (base::_data) {
+                for (int i = 0; i < base::_n; i++) {
+                    (*this)[i].~Type();
+                }
                 Allocator::deallocate(rv_array<Type>::_data);
+            }
             base::_data = nullptr;
             base::_n = 0;
             _maxItems = 0;
@@ -1559,71 +1683,253 @@ namespace intercept::types {
         using key_type = const Type&;
         static bool equals(key_type a_, key_type b_) { return a_ == b_; }
         static key_type get_key(const Type& a_) { return a_; }
+        ///Only needed for an indexed find_key_array
+        static size_t hash(key_type a_) { return std::hash<Type>()(a_); }
     };
 
-    template <class Type, class Traits = find_key_array_traits<Type>>
-    class find_key_array : public auto_array<Type> {
+    namespace __internal {
+        ///find_key_array without a side index, lookups scan the array
+        template <class Type, class Traits, bool Indexed>
+        class find_key_array_index {
+        protected:
+            using key_type = typename Traits::key_type;
+
+            std::optional<uint32_t> index_find(const auto_array<Type>& array_, key_type key_) const {
+                for (size_t i = 0; i < array_.count(); i++)
+                    if (Traits::equals(Traits::get_key(array_[i]), key_)) return static_cast<uint32_t>(i);
+                return {};
+            }
+            void index_invalidate() noexcept {}
+        };
+
+        /**
+         * @brief Side index of a find_key_array, maps the hash of a key to the first element with that key.
+         * @description Open addressing with linear probing, the table is at most half full. Elements that were appended
+         * since the last lookup are added on the next one, anything that moves elements around invalidates the index
+         * and the next lookup rebuilds it.
+         */
+        template <class Type, class Traits>
+        class find_key_array_index<Type, Traits, true> {
+        protected:
+            using key_type = typename Traits::key_type;
+
+            std::optional<uint32_t> index_find(const auto_array<Type>& array_, key_type key_) const {
+                update(array_);
+                if (_slots.empty()) return {};
+                for (auto slot = slot_of(Traits::hash(key_));; slot = (slot + 1) & (_slots.size() - 1)) {
+                    const auto entry = _slots[slot];
+                    if (!entry) return {};
+                    if (Traits::equals(Traits::get_key(array_[entry - 1]), key_)) return entry - 1;
+                }
+            }
+            void index_invalidate() noexcept { _stale = true; }
+
+        private:
+            //Fibonacci hashing, std::hash of pointers and numbers leaves the low bits that the table uses mostly unchanged
+            size_t slot_of(size_t hash_) const noexcept {
+                return static_cast<size_t>((static_cast<uint64_t>(hash_) * 0x9E3779B97F4A7C15ull) >> _shift);
+            }
+
+            void update(const auto_array<Type>& array_) const {
+                const auto count = array_.count();
+                if (_stale || count < _indexed || count * 2 > _slots.size()) {
+                    size_t size = 16;
+                    while (size < count * 2) size *= 2;
+                    _slots.assign(size, 0);
+                    _shift = 64;
+                    for (; size > 1; size /= 2) --_shift;
+                    _indexed = 0;
+                    _stale = false;
+                }
+                for (; _indexed < count; ++_indexed) add(array_, _indexed);
+            }
+
+            void add(const auto_array<Type>& array_, size_t index_) const {
+                auto&& key = Traits::get_key(array_[index_]);
+                for (auto slot = slot_of(Traits::hash(key));; slot = (slot + 1) & (_slots.size() - 1)) {
+                    const auto entry = _slots[slot];
+                    if (!entry) {
+                        _slots[slot] = static_cast<uint32_t>(index_ + 1);
+                        return;
+                    }
+                    //find_by_key returns the first element with a key, so duplicates after it aren't indexed
+                    if (Traits::equals(Traits::get_key(array_[entry - 1]), key)) return;
+                }
+            }
+
+            ///Index of the element + 1, 0 is an empty slot
+            mutable std::vector<uint32_t> _slots;
+            mutable unsigned _shift = 64;
+            mutable size_t _indexed = 0;
+            mutable bool _stale = false;
+        };
+
+        ///Base of a find_key_array without an index, it is a plain auto_array
+        template <class Type, bool Indexed>
+        class find_key_array_base : public auto_array<Type> {
+        public:
+            using auto_array<Type>::auto_array;
+        };
+
+        /**
+         * @brief Base of an indexed find_key_array.
+         * @description The index only sees what goes through find_key_array, an auto_array reference to it could
+         * move elements behind the index's back. So the auto_array is a protected base, only reading and appending
+         * are public here and find_key_array wraps erase, insert, emplace, resize and clear.
+         */
+        template <class Type>
+        class find_key_array_base<Type, true> : protected auto_array<Type> {
+            using base = auto_array<Type>;
+
+        public:
+            using base::base;
+            using iterator = typename base::iterator;
+            using const_iterator = typename base::const_iterator;
+
+            using base::begin;
+            using base::end;
+            using base::cbegin;
+            using base::cend;
+            using base::data;
+            using base::count;
+            using base::size;
+            using base::empty;
+            using base::is_empty;
+            using base::get;
+            using base::operator[];
+            using base::front;
+            using base::back;
+            using base::for_each;
+            using base::hash;
+
+            using base::reserve;
+            using base::shrink_to_fit;
+            using base::push_back;
+            using base::emplace_back;
+            using base::append_range;
+        };
+    }  // namespace __internal
+
+    /**
+     * @brief auto_array that can find elements by key.
+     * @description Lookups scan the whole array unless Indexed is set. Then a hash index on the side answers them,
+     * which makes push_back_unique and find_or_push_back O(1). The index picks up appended elements by itself, and is
+     * rebuilt after delete_at, delete_all_by_key and the erase, insert and resize of the array. If you change the
+     * key of an element in place or reorder elements through iterators, call invalidate_index.
+     * The index isn't part of the engines layout, only use Indexed for arrays that the plugin owns. An indexed
+     * find_key_array is not an auto_array, so it can't be changed past the index.
+     */
+    template <class Type, class Traits = find_key_array_traits<Type>, bool Indexed = false>
+    class
+#ifdef _MSC_VER
+        __declspec(empty_bases)
+#endif
+        find_key_array : public __internal::find_key_array_base<Type, Indexed>,
+                         private __internal::find_key_array_index<Type, Traits, Indexed> {
         using base = auto_array<Type>;
+        using key_index = __internal::find_key_array_index<Type, Traits, Indexed>;
         using key_type = typename Traits::key_type;
 
     public:
-        void delete_at(uint32_t index_) { base::erase(index_, 1); }
-        void delete_at(uint32_t index_, uint32_t count_) { base::erase(index_, count_); }
+        using __internal::find_key_array_base<Type, Indexed>::find_key_array_base;
+
+        void delete_at(uint32_t index_) { erase(index_, 1); }
+        void delete_at(uint32_t index_, uint32_t count_) { erase(index_, count_); }
         bool delete_by_key(key_type key_) {
-            const int index = find_by_key(key_);
-            if (index < 0) return false;
-            delete_at(index);
+            const auto index = find_by_key(key_);
+            if (!index) return false;
+            delete_at(*index);
             return true;
         }
 
         void delete_all_by_key(key_type key_) {
-            base::erase(std::remove_if(base::begin(), base::end(), [key_](const Type& el) {
-                            return Traits::equals(Traits::get_key(el), key_);
-                        }),
-                        base::end());
+            erase(std::remove_if(base::begin(), base::end(), [&key_](const Type& el) {
+                      return Traits::equals(Traits::get_key(el), key_);
+                  }),
+                  base::end());
         }
 
         std::optional<uint32_t> find(const Type& elem_) const {
             return find_by_key(Traits::get_key(elem_));
         }
         std::optional<uint32_t> find_by_key(key_type key_) const {
-            for (int i = 0; i < base::Size(); i++)
-                if (Traits::equals(Traits::get_key(base::get(i)), key_)) return i;
-            return {};
+            return key_index::index_find(*this, key_);
         }
 
+        ///Returns the index of the new element, or nothing if an element with the same key already exists
         std::optional<uint32_t> push_back_unique(const Type& src_) {
-            if (find(src_)) return -1;
-            return this->push_back(src_);
+            if (find(src_)) return {};
+            base::push_back(src_);
+            return static_cast<uint32_t>(base::count() - 1);
         }
 
         uint32_t find_or_push_back(const Type& src_) {
             auto index = find(src_);
-            if (index) return index;
-            return this->push_back(src_);
+            if (index) return *index;
+            base::push_back(src_);
+            return static_cast<uint32_t>(base::count() - 1);
+        }
+
+        ///Rebuilds the index on the next lookup
+        void invalidate_index() noexcept { key_index::index_invalidate(); }
+
+        //Everything that moves elements around has to tell the index, appending doesn't
+        template <class... Args>
+        void erase(Args&&... args_) {
+            base::erase(std::forward<Args>(args_)...);
+            key_index::index_invalidate();
+        }
+        template <class... Args>
+        auto insert(Args&&... args_) {
+            auto result = base::insert(std::forward<Args>(args_)...);
+            key_index::index_invalidate();
+            return result;
+        }
+        auto insert(typename base::iterator where_, const std::initializer_list<Type>& values_) {
+            auto result = base::insert(where_, values_);
+            key_index::index_invalidate();
+            return result;
+        }
+        template <class... Args>
+        auto emplace(typename base::iterator where_, Args&&... args_) {
+            auto result = base::emplace(where_, std::forward<Args>(args_)...);
+            key_index::index_invalidate();
+            return result;
+        }
+        void resize(const size_t n_) {
+            base::resize(n_);
+            key_index::index_invalidate();
+        }
+        void clear() {
+            base::clear();
+            key_index::index_invalidate();
         }
     };
 
+    //The engine has these in its own structures, without an index they have to stay plain auto_arrays
+    static_assert(sizeof(find_key_array<int>) == sizeof(auto_array<int>), "find_key_array has to keep the layout of auto_array");
+
     template <class Type>
     struct reference_array_find_key_array_traits {
-        using key_type = const Type&;
+        using key_type = const Type*;
         static bool equals(key_type a_, key_type b_) { return a_ == b_; }
-        static key_type get_key(const Type& a_) { return a_.get(); }
+        static key_type get_key(const ref<Type>& a_) { return a_.get(); }
+        static size_t hash(key_type a_) { return std::hash<key_type>()(a_); }
     };
 
-    template <class Type>
-    class reference_array : public find_key_array<ref<Type>, reference_array_find_key_array_traits<Type>> {
-        using base = find_key_array<ref<Type>, reference_array_find_key_array_traits<Type>>;
+    template <class Type, bool Indexed = false>
+    class reference_array : public find_key_array<ref<Type>, reference_array_find_key_array_traits<Type>, Indexed> {
+        using base = find_key_array<ref<Type>, reference_array_find_key_array_traits<Type>, Indexed>;
         using traits = reference_array_find_key_array_traits<Type>;
 
     public:
         using base::delete_at;
 
         bool delete_at(const Type* el_) { return base::delete_by_key(el_); }
-        bool delete_at(const ref<Type>& src_) const { return base::delete_by_key(traits::get_key(src_)); }
+        bool delete_at(const ref<Type>& src_) { return base::delete_by_key(traits::get_key(src_)); }
 
-        bool find(const Type* el_) { return base::find_by_key(el_); }
-        bool find(const ref<Type>& src_) const { return base::find_by_key(traits::get_key(src_)); }
+        bool find(const Type* el_) const { return base::find_by_key(el_).has_value(); }
+        bool find(const ref<Type>& src_) const { return base::find_by_key(traits::get_key(src_)).has_value(); }
     };
 
     /*
@@ -1845,19 +2151,18 @@ namespace intercept::types {
 
         //ArmaDebugEngine
         void rebuild(int tableSize) {
+            auto oldTable = _table;
             auto oldTableCount = _tableCount;
             _tableCount = tableSize;
-            auto newTable = rv_allocator<Container>::create_array(tableSize);
-            for (auto i = 0; i < _tableCount; i++) {
-                auto& container = newTable[i];
-                for (Type& item : container) {
+            _table = rv_allocator<Container>::create_array(tableSize);
+            //hash_key already uses the new table size
+            for (auto i = 0; i < oldTableCount; i++) {
+                for (Type& item : oldTable[i]) {
                     auto hashedKey = hash_key(item.get_map_key());
-                    auto it = newTable[hashedKey].emplace(newTable[hashedKey].end(), Type());
-                    *it = std::move(item);
+                    _table[hashedKey].emplace_back(std::move(item));
                 }
             }
-            std::swap(_table, newTable);
-            rv_allocator<Container>::destroy_deallocate(newTable, oldTableCount);
+            if (oldTable) rv_allocator<Container>::destroy_deallocate(oldTable, oldTableCount);
         }
 
         Type& insert(const Type& value) {
@@ -1916,7 +2221,7 @@ namespace intercept::types {
             int hashedKey = hash_key(key);
             for (size_t i = 0; i < _table[hashedKey].size(); i++) {
                 Type& item = _table[hashedKey][i];
-                if (Traits::compare_keys(item.get_map_key(), key) == 0) {
+                if (Traits::compare_keys(item.get_map_key(), key)) {
                     _table[hashedKey].erase(_table[hashedKey].begin() + i);
                     _count--;
                     return true;
@@ -1939,6 +2244,319 @@ namespace intercept::types {
     template <class Type, class Container, class Traits>
     Type map_string_to_class<Type, Container, Traits>::_null_entry;
 
+    namespace __internal {
+        //string_map works on 8 bytes of a key at once, that's what these helpers are for
+        ///Loads up to 8 bytes, the rest is zero
+        inline uint64_t swar_load(const char* data_, size_t length_) noexcept {
+            uint64_t bytes = 0;
+            std::memcpy(&bytes, data_, length_);
+            return bytes;
+        }
+
+        ///Lowercases the ASCII letters in 8 bytes at once and leaves every other byte alone, like tolower in the C locale
+        inline uint64_t swar_ascii_tolower(uint64_t bytes_) noexcept {
+            const uint64_t heptets = bytes_ & ~swar_msbs;
+            const uint64_t from_a = heptets + swar_lsbs * (0x80 - 'A');
+            const uint64_t above_z = heptets + swar_lsbs * (0x7F - 'Z');
+            const uint64_t upper = (from_a ^ above_z) & ~bytes_ & swar_msbs;
+            return bytes_ | (upper >> 2);
+        }
+
+        template <bool CaseInsensitive>
+        uint64_t string_map_hash(std::string_view key_) noexcept {
+            constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+            uint64_t hash = key_.length() * multiplier;
+            auto mix = [&hash](uint64_t bytes_) {
+                if constexpr (CaseInsensitive) bytes_ = swar_ascii_tolower(bytes_);
+                hash = (hash ^ bytes_) * 0xBF58476D1CE4E5B9ull;
+                hash ^= hash >> 31;
+            };
+            auto data = key_.data();
+            auto left = key_.length();
+            for (; left >= 8; data += 8, left -= 8) mix(swar_load(data, 8));
+            if (left) mix(swar_load(data, left));
+            hash *= multiplier;
+            return hash ^ (hash >> 32);
+        }
+
+        inline bool string_map_equal_caseinsensitive(std::string_view k1, std::string_view k2) noexcept {
+            if (k1.length() != k2.length()) return false;
+            auto left = k1.length();
+            size_t offset = 0;
+            for (; left >= 8; offset += 8, left -= 8) {
+                if (swar_ascii_tolower(swar_load(k1.data() + offset, 8)) != swar_ascii_tolower(swar_load(k2.data() + offset, 8))) return false;
+            }
+            return !left || swar_ascii_tolower(swar_load(k1.data() + offset, left)) == swar_ascii_tolower(swar_load(k2.data() + offset, left));
+        }
+    }  // namespace __internal
+
+    struct string_map_trait {
+        static uint64_t hash_key(std::string_view key) noexcept {
+            return __internal::string_map_hash<false>(key);
+        }
+        static bool compare_keys(std::string_view k1, std::string_view k2) noexcept {
+            return k1 == k2;
+        }
+    };
+
+    struct string_map_trait_caseinsensitive {
+        ///Same result for all spellings of a key, without calling tolower on every byte
+        static uint64_t hash_key(std::string_view key) noexcept {
+            return __internal::string_map_hash<true>(key);
+        }
+        static bool compare_keys(std::string_view k1, std::string_view k2) noexcept {
+            return __internal::string_map_equal_caseinsensitive(k1, k2);
+        }
+    };
+
+    /**
+     * @brief Map of Type by Type::get_map_key(), for maps that the plugin owns.
+     * @description Same interface as map_string_to_class, but it isn't laid out like the engines maps, so never use it
+     * for a map that the engine reads. The table is open addressing with a power of two capacity that doubles when it
+     * is 7/8 full. Every slot has a control byte with 7 bits of the keys hash, or whether it's empty or deleted.
+     * A lookup checks the control bytes of 8 slots at once and only compares keys whose hash bits match, so a missing
+     * key is usually rejected without touching a single string.
+     * Entries move when the table grows, don't hold on to references across an insert.
+     */
+    template <class Type, class Traits = string_map_trait>
+    class string_map {
+        template <class Map, class Value>
+        class basic_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Type;
+            using difference_type = ptrdiff_t;
+            using pointer = Value*;
+            using reference = Value&;
+
+            basic_iterator(Map* map_, size_t index_) noexcept : _map(map_), _index(index_) { skip_free(); }
+            Value& operator*() const noexcept { return _map->_slots[_index]; }
+            Value* operator->() const noexcept { return &_map->_slots[_index]; }
+            basic_iterator& operator++() noexcept {
+                ++_index;
+                skip_free();
+                return *this;
+            }
+            basic_iterator operator++(int) noexcept {
+                auto tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            bool operator==(const basic_iterator& other_) const noexcept { return _index == other_._index; }
+            bool operator!=(const basic_iterator& other_) const noexcept { return _index != other_._index; }
+
+        private:
+            void skip_free() noexcept {
+                while (_index < _map->_capacity && !control::is_full(_map->_control[_index])) ++_index;
+            }
+            Map* _map;
+            size_t _index;
+        };
+
+    public:
+        using iterator = basic_iterator<string_map, Type>;
+        using const_iterator = basic_iterator<const string_map, const Type>;
+
+        string_map() noexcept = default;
+        string_map(const string_map& other_) {
+            if (!other_._count) return;
+            allocate(other_._capacity);
+            std::memcpy(_control, other_._control, _capacity);
+            for (size_t i = 0; i < _capacity; ++i) {
+                if (control::is_full(_control[i])) ::new (_slots + i) Type(other_._slots[i]);
+            }
+            _count = other_._count;
+            _deleted = other_._deleted;
+        }
+        string_map(string_map&& other_) noexcept { swap(other_); }
+        string_map& operator=(const string_map& other_) {
+            if (this != &other_) string_map(other_).swap(*this);
+            return *this;
+        }
+        string_map& operator=(string_map&& other_) noexcept {
+            string_map(std::move(other_)).swap(*this);
+            return *this;
+        }
+        ~string_map() {
+            clear();
+            deallocate();
+        }
+
+        void swap(string_map& other_) noexcept {
+            std::swap(_control, other_._control);
+            std::swap(_slots, other_._slots);
+            std::swap(_capacity, other_._capacity);
+            std::swap(_count, other_._count);
+            std::swap(_deleted, other_._deleted);
+        }
+
+        iterator begin() noexcept { return iterator(this, 0); }
+        iterator end() noexcept { return iterator(this, _capacity); }
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+        const_iterator end() const noexcept { return const_iterator(this, _capacity); }
+
+        template <class Func>
+        void for_each(Func func_) const {
+            for (auto& item : *this) func_(item);
+        }
+
+        int count() const noexcept { return static_cast<int>(_count); }
+        size_t size() const noexcept { return _count; }
+        bool empty() const noexcept { return !_count; }
+        size_t capacity() const noexcept { return _capacity; }
+
+        ///Returns nullptr if the key isn't in the map
+        Type* find(std::string_view key_) noexcept {
+            const auto index = find_index(key_, Traits::hash_key(key_));
+            return index == npos ? nullptr : _slots + index;
+        }
+        const Type* find(std::string_view key_) const noexcept {
+            const auto index = find_index(key_, Traits::hash_key(key_));
+            return index == npos ? nullptr : _slots + index;
+        }
+
+        ///Returns a null entry if the key isn't in the map, check with is_null
+        Type& get(std::string_view key_) noexcept {
+            auto found = find(key_);
+            return found ? *found : _null_entry;
+        }
+        const Type& get(std::string_view key_) const noexcept {
+            auto found = find(key_);
+            return found ? *found : _null_entry;
+        }
+
+        static bool is_null(const Type& value_) noexcept { return &value_ == &_null_entry; }
+
+        bool has_key(std::string_view key_) const noexcept {
+            return find(key_) != nullptr;
+        }
+
+        ///Keeps the existing entry if the key is already in the map
+        Type& insert(const Type& value_) {
+            const auto key = value_.get_map_key();
+            const auto hash = Traits::hash_key(key);
+            const auto index = find_index(key, hash);
+            if (index != npos) return _slots[index];
+            return emplace_new(hash, value_);
+        }
+
+        ///Replaces the existing entry if the key is already in the map
+        Type& insert(Type&& value_) {
+            const auto key = value_.get_map_key();
+            const auto hash = Traits::hash_key(key);
+            const auto index = find_index(key, hash);
+            if (index != npos) return _slots[index] = std::move(value_);
+            return emplace_new(hash, std::move(value_));
+        }
+
+        bool remove(std::string_view key_) {
+            const auto index = find_index(key_, Traits::hash_key(key_));
+            if (index == npos) return false;
+
+            control::erase(_control, index, _deleted);
+            --_count;
+            _slots[index].~Type();
+            return true;
+        }
+
+        ///Removes all entries, the map keeps its capacity
+        void clear() noexcept {
+            if (!_capacity) return;
+            for (size_t i = 0; i < _capacity; ++i) {
+                if (control::is_full(_control[i])) _slots[i].~Type();
+            }
+            std::memset(_control, control::empty, _capacity);
+            _count = 0;
+            _deleted = 0;
+        }
+
+        ///Makes room for count_ entries without growing in between
+        void reserve(size_t count_) {
+            if (count_ > max_load(_capacity)) rehash(capacity_for(count_));
+        }
+
+    private:
+        using control = __internal::swiss_control;
+        static constexpr size_t npos = control::npos;
+        static constexpr size_t min_capacity = control::group_size * 2;
+
+        static size_t max_load(size_t capacity_) noexcept { return control::max_load(capacity_); }
+        static size_t capacity_for(size_t count_) noexcept {
+            size_t capacity = min_capacity;
+            while (max_load(capacity) < count_) capacity *= 2;
+            return capacity;
+        }
+
+        size_t find_index(std::string_view key_, uint64_t hash_) const noexcept {
+            if (!_count) return npos;
+            return control::find(_control, _capacity, hash_, [this, key_](size_t index_) {
+                return Traits::compare_keys(_slots[index_].get_map_key(), key_);
+            });
+        }
+
+        size_t insert_index(uint64_t hash_) noexcept {
+            return control::insert(_control, _capacity, hash_, _deleted);
+        }
+
+        template <class Value>
+        Type& emplace_new(uint64_t hash_, Value&& value_) {
+            //Mostly deleted entries just need a cleanup, otherwise the map doubles
+            if (_count + _deleted + 1 > max_load(_capacity)) {
+                if (!_capacity) rehash(min_capacity);
+                else rehash(_count * 2 < max_load(_capacity) ? _capacity : _capacity * 2);
+            }
+            const auto index = insert_index(hash_);
+            ::new (_slots + index) Type(std::forward<Value>(value_));
+            ++_count;
+            return _slots[index];
+        }
+
+        void rehash(size_t capacity_) {
+            auto old_control = _control;
+            auto old_slots = _slots;
+            const auto old_capacity = _capacity;
+
+            allocate(capacity_);
+            std::memset(_control, control::empty, _capacity);
+            _deleted = 0;
+            for (size_t i = 0; i < old_capacity; ++i) {
+                if (!control::is_full(old_control[i])) continue;
+                const auto index = insert_index(Traits::hash_key(old_slots[i].get_map_key()));
+                ::new (_slots + index) Type(std::move(old_slots[i]));
+                old_slots[i].~Type();
+            }
+            if (old_capacity) {
+                __internal::rv_allocator_deallocate_generic(old_control);
+                __internal::rv_allocator_deallocate_generic(old_slots);
+            }
+        }
+
+        void allocate(size_t capacity_) {
+            _capacity = capacity_;
+            _control = static_cast<uint8_t*>(__internal::rv_allocator_allocate_generic(_capacity));
+            _slots = static_cast<Type*>(__internal::rv_allocator_allocate_generic(sizeof(Type) * _capacity));
+        }
+
+        void deallocate() noexcept {
+            if (!_capacity) return;
+            __internal::rv_allocator_deallocate_generic(_control);
+            __internal::rv_allocator_deallocate_generic(_slots);
+            _control = nullptr;
+            _slots = nullptr;
+            _capacity = 0;
+        }
+
+        uint8_t* _control = nullptr;
+        Type* _slots = nullptr;
+        size_t _capacity = 0;
+        size_t _count = 0;
+        size_t _deleted = 0;
+        static Type _null_entry;
+    };
+
+    template <class Type, class Traits>
+    Type string_map<Type, Traits>::_null_entry;
+
 #pragma endregion
 }
 
@@ -16,7 +16,7 @@ https://github.com/NouberNou/intercept
 
 using namespace intercept::types;
 
-#define INTERCEPT_SDK_API_VERSION 2
+#define INTERCEPT_SDK_API_VERSION 3
 
 namespace intercept {
     class extensions;
@@ -31,6 +31,14 @@ namespace intercept {
     namespace client {
         class host;
     }
+
+    /*!
+    @brief Receives the result of a call queued through client_functions_v3::invoke_raw_nular_async and friends.
+
+    Called on the main thread, the callback may move from result_. It must not throw.
+    */
+    using invoke_async_callback = void(*)(void *user_data_, game_value &result_);
+
     extern "C" {
         struct client_functions {
             friend class client::host;
@@ -123,5 +131,53 @@ namespace intercept {
             std::pair<r_string, auto_array<uint32_t>>(*list_plugin_interfaces)(std::string_view name_);
             void*(*request_plugin_interface)(r_string module_name_, std::string_view name_, uint32_t api_version_);
         };
+        //Passed by value, on x86 anything added here moves the module_name argument of assign_functions
+        static_assert(sizeof(client_functions) == 24 * sizeof(void*), "client_functions is frozen, add new functions to client_functions_v3");
+
+        /*!
+        @brief Functions added with API version 3.
+
+        client_functions is passed to assign_functions by value, so its layout has to stay
+        what older plugins and hosts were built with. Everything newer is in this table, which
+        hosts of API version 3 or later pass by pointer to assign_functions_v3 if the plugin
+        exports it. Under an older host it stays zeroed.
+        */
+        struct client_functions_v3 {
+            /*!@{
+            @brief Queues a raw SQF function call without taking the invoker lock.
+
+            The call is executed by the main thread at the start of the next invoke
+            period, together with all other queued calls. Calls from the main thread
+            are executed immediately. Either way callback_ receives the raw returned
+            data together with user_data_.
+
+            Nothing but plain pointers crosses the module boundary, so host and
+            plugin don't have to share a C++ runtime. callback_ lives in the plugin,
+            so calls that are still queued when it unloads are executed right then.
+
+            @param module_id_ The id get_module_id returned for the calling plugin.
+            @see intercept::client::host::invoke_raw_async
+            */
+            void(*invoke_raw_nular_async)(uint32_t module_id_, nular_function function_, invoke_async_callback callback_, void *user_data_);
+            void(*invoke_raw_unary_async)(uint32_t module_id_, unary_function function_, const game_value &right_arg_, invoke_async_callback callback_, void *user_data_);
+            void(*invoke_raw_binary_async)(uint32_t module_id_, binary_function function_, const game_value &left_arg_, const game_value &right_arg_, invoke_async_callback callback_, void *user_data_);
+            //!@}
+
+            /*!
+            @brief Returns the invoker telemetry: client lock wait times, invoke
+            period usage and the cost of every plugins `on_frame`.
+
+            @param reset_ Clears all histograms after reading them, so the next
+            call only reports what happened in between.
+            */
+            auto_array<invoker_metric>(*get_invoker_metrics)(bool reset_);
+
+            /*!
+            @brief Returns the id the host routes InterceptClientEvent calls by.
+
+            @param module_name_ The name that was passed to assign_functions.
+            */
+            uint32_t(*get_module_id)(std::string_view module_name_);
+        };
     }
 }
@@ -0,0 +1,111 @@
+/*!
+@file
+@brief Control bytes and probing of the open addressing maps that are laid out like a SwissTable.
+
+string_map and eh_flat_map only differ in their keys and in how they store
+their values, they find and claim slots the same way.
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace intercept::types::__internal {
+    constexpr uint64_t swar_lsbs = 0x0101010101010101ull;
+    constexpr uint64_t swar_msbs = 0x8080808080808080ull;
+
+    /**
+     * @brief Works on the control bytes of a SwissTable, the map owns them and its slots.
+     * @description Every slot has a control byte holding 7 bits of its hash, or whether it is empty or deleted.
+     * A lookup compares the control bytes of 8 slots at once and only looks at keys whose hash bits match.
+     * The capacity is a power of two of at least two groups.
+     * @private
+     */
+    struct swiss_control {
+        static constexpr size_t npos = ~size_t(0);
+        static constexpr size_t group_size = 8;
+        static constexpr uint8_t empty = 0x80;
+        static constexpr uint8_t deleted = 0xFE;
+
+        static bool is_full(uint8_t control_) noexcept { return (control_ & 0x80) == 0; }
+        ///Tables grow when they are 7/8 full
+        static size_t max_load(size_t capacity_) noexcept { return capacity_ - capacity_ / 8; }
+        static uint8_t h2(uint64_t hash_) noexcept { return static_cast<uint8_t>(hash_ & 0x7F); }
+
+        static uint64_t load_group(const uint8_t* control_, size_t index_) noexcept {
+            uint64_t group;
+            std::memcpy(&group, control_ + index_, sizeof(group));
+            return group;
+        }
+        //One bit set in the top bit of every matching byte, might have false positives that the key compare sorts out
+        static uint64_t match(uint64_t group_, uint8_t h2_) noexcept {
+            const auto bytes = group_ ^ (swar_lsbs * h2_);
+            return (bytes - swar_lsbs) & ~bytes & swar_msbs;
+        }
+        static uint64_t match_empty(uint64_t group_) noexcept { return group_ & ~(group_ << 6) & swar_msbs; }
+        static uint64_t match_empty_or_deleted(uint64_t group_) noexcept { return group_ & ~(group_ << 7) & swar_msbs; }
+
+        static size_t first_byte(uint64_t mask_) noexcept {
+        #if defined(__GNUC__)
+            return static_cast<size_t>(__builtin_ctzll(mask_)) / 8;
+        #else
+            size_t byte = 0;
+            while (!(mask_ & 0x80)) {
+                mask_ >>= 8;
+                ++byte;
+            }
+            return byte;
+        #endif
+        }
+
+        /**
+         * @brief Returns the first slot with the hash bits of hash_ that key_matches_(index) accepts, or npos.
+         */
+        template <class KeyMatches>
+        static size_t find(const uint8_t* control_, size_t capacity_, uint64_t hash_, KeyMatches&& key_matches_) {
+            const size_t group_mask = capacity_ / group_size - 1;
+            auto group_index = static_cast<size_t>(hash_ >> 7) & group_mask;
+            for (size_t step = 1;; ++step) {
+                const auto offset = group_index * group_size;
+                const auto group = load_group(control_, offset);
+                for (auto candidates = match(group, h2(hash_)); candidates; candidates &= candidates - 1) {
+                    const auto index = offset + first_byte(candidates);
+                    if (key_matches_(index)) return index;
+                }
+                if (match_empty(group)) return npos;
+                //Triangular steps visit every group once since the group count is a power of two
+                group_index = (group_index + step) & group_mask;
+            }
+        }
+
+        /**
+         * @brief Claims a free slot for hash_ and returns it, the table must have one.
+         * @param deleted_ Number of deleted slots in the table, a reused one is counted down.
+         */
+        static size_t insert(uint8_t* control_, size_t capacity_, uint64_t hash_, size_t& deleted_) noexcept {
+            const size_t group_mask = capacity_ / group_size - 1;
+            auto group_index = static_cast<size_t>(hash_ >> 7) & group_mask;
+            for (size_t step = 1;; ++step) {
+                const auto offset = group_index * group_size;
+                if (const auto free = match_empty_or_deleted(load_group(control_, offset))) {
+                    const auto index = offset + first_byte(free);
+                    if (control_[index] == deleted) --deleted_;
+                    control_[index] = h2(hash_);
+                    return index;
+                }
+                group_index = (group_index + step) & group_mask;
+            }
+        }
+
+        /**
+         * @brief Frees a full slot.
+         * @param deleted_ Number of deleted slots in the table, counted up if the slot can't become empty.
+         */
+        static void erase(uint8_t* control_, size_t index_, size_t& deleted_) noexcept {
+            //Probes stop at a group with an empty slot, so if this group has one, nothing probes past it
+            const bool group_has_empty = match_empty(load_group(control_, index_ & ~(group_size - 1))) != 0;
+            control_[index_] = group_has_empty ? empty : deleted;
+            if (!group_has_empty) ++deleted_;
+        }
+    };
+}  // namespace intercept::types::__internal
@@ -1572,6 +1572,20 @@ namespace intercept {
             invalid_interface_class
         };
 
+        /*!
+        @brief Summary of one invoker telemetry histogram.
+
+        Durations are in microseconds, utilization in percent of the invoke
+        period budget.
+        */
+        struct invoker_metric {
+            r_string name;
+            uint64_t count{};
+            uint32_t p50{};
+            uint32_t p99{};
+            uint32_t max{};
+        };
+
     }  // namespace types
 }  // namespace intercept
 
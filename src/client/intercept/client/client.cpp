@@ -6,7 +6,9 @@ using namespace intercept::types;
 namespace intercept {
     namespace client {
         client_functions host::functions;
+        client_functions_v3 host::functions_v3;
         r_string host::module_name;
+        uint32_t host::module_id;
 
         registered_sqf_function host::registerFunction(std::string_view name, std::string_view description, WrapperFunctionBinary function_, game_data_type return_arg_type, game_data_type left_arg_type, game_data_type right_arg_type) {
             return functions.register_sqf_function(name, description, function_, return_arg_type, left_arg_type, right_arg_type);
@@ -53,6 +55,51 @@ namespace intercept {
             return {};
         }
 
+        namespace {
+            void fulfil_async_invoke(void *user_data_, game_value &result_) {
+                std::unique_ptr<std::promise<game_value>> promise(static_cast<std::promise<game_value> *>(user_data_));
+                promise->set_value(std::move(result_));
+            }
+        }
+
+        //Hosts without the async queue get the call made right away under the invoker lock
+        std::future<game_value> host::invoke_raw_async(nular_function function_) {
+            auto promise = new std::promise<game_value>();
+            auto result = promise->get_future();
+            if (functions_v3.invoke_raw_nular_async) {
+                functions_v3.invoke_raw_nular_async(module_id, function_, fulfil_async_invoke, promise);
+            } else {
+                invoker_lock lock;
+                game_value value = functions.invoke_raw_nular(function_);
+                fulfil_async_invoke(promise, value);
+            }
+            return result;
+        }
+        std::future<game_value> host::invoke_raw_async(unary_function function_, const game_value &right_arg_) {
+            auto promise = new std::promise<game_value>();
+            auto result = promise->get_future();
+            if (functions_v3.invoke_raw_unary_async) {
+                functions_v3.invoke_raw_unary_async(module_id, function_, right_arg_, fulfil_async_invoke, promise);
+            } else {
+                invoker_lock lock;
+                game_value value = functions.invoke_raw_unary(function_, right_arg_);
+                fulfil_async_invoke(promise, value);
+            }
+            return result;
+        }
+        std::future<game_value> host::invoke_raw_async(binary_function function_, const game_value &left_arg_, const game_value &right_arg_) {
+            auto promise = new std::promise<game_value>();
+            auto result = promise->get_future();
+            if (functions_v3.invoke_raw_binary_async) {
+                functions_v3.invoke_raw_binary_async(module_id, function_, left_arg_, right_arg_, fulfil_async_invoke, promise);
+            } else {
+                invoker_lock lock;
+                game_value value = functions.invoke_raw_binary(function_, left_arg_, right_arg_);
+                fulfil_async_invoke(promise, value);
+            }
+            return result;
+        }
+
         // Using __cdecl to prevent name mangling and provide better backwards compatibility
         void CDECL assign_functions(const struct client_functions funcs, r_string module_name) {
             host::functions = funcs;
@@ -148,6 +195,11 @@ namespace intercept {
             sqf_script_type::type_def = type_def;
         }
 
+        void CDECL assign_functions_v3(const struct client_functions_v3 *funcs, r_string module_name) {
+            host::functions_v3 = *funcs;
+            host::module_id = host::functions_v3.get_module_id ? host::functions_v3.get_module_id(module_name) : 0;
+        }
+
         invoker_lock::invoker_lock(bool delayed_) : _locked(false) {
             if (!delayed_)
                 lock();
@@ -1,17 +1,166 @@
 #include "pointers.hpp"
 
 #ifndef INTERCEPT_NO_SQF
+#ifdef INTERCEPT_LAZY_SQF
+#include <array>
+#include <atomic>
+#include <utility>
+#endif
+
 namespace intercept {
     namespace client {
 #include "sqf_pointers_definitions.hpp"
         binary_function __sqf::binary__configaccessor__config__string__ret__config;
+
+    #ifndef INTERCEPT_LAZY_SQF
         void __sqf::__initialize()
         {
 #include "sqf_assignments.hpp"
             __sqf::binary__configaccessor__config__string__ret__config = host::functions.get_binary_function_typed(">>"sv, "CONFIG"sv, "STRING"sv);
         }
+    #else
+        /*
+        Lazy mode
+
+        Instead of asking the host for every function at load, each __sqf pointer
+        is set to a stub. The first call through a stub looks up the real function
+        and remembers it, later calls forward to it directly. Functions that don't
+        exist in the running game version return nil instead of crashing.
+
+        The stubs are instantiated from templates, one per index, and handed out in
+        order while sqf_assignments.hpp runs against the lazy host below.
+        */
+        namespace __lazy_sqf {
+            constexpr size_t nular_capacity = 384;
+            constexpr size_t unary_capacity = 1536;
+            constexpr size_t binary_capacity = 1536;
+
+            template <typename Function>
+            struct lazy_slot {
+                std::string_view name;
+                std::string_view left_type;
+                std::string_view right_type;
+                std::atomic<Function> function{nullptr};
+                std::atomic<bool> resolved{false};
+
+                Function resolve() {
+                    if (resolved.load(std::memory_order_acquire)) return function.load(std::memory_order_relaxed);
+                    //Several threads might race here, they all store the same result
+                    Function found;
+                    if constexpr (std::is_same_v<Function, nular_function>)
+                        found = intercept::client::host::functions.get_nular_function(name);
+                    else if constexpr (std::is_same_v<Function, unary_function>)
+                        found = intercept::client::host::functions.get_unary_function_typed(name, right_type);
+                    else
+                        found = intercept::client::host::functions.get_binary_function_typed(name, left_type, right_type);
+                    function.store(found, std::memory_order_relaxed);
+                    resolved.store(true, std::memory_order_release);
+                    return found;
+                }
+            };
+
+            std::array<lazy_slot<nular_function>, nular_capacity> nular_slots;
+            std::array<lazy_slot<unary_function>, unary_capacity> unary_slots;
+            std::array<lazy_slot<binary_function>, binary_capacity> binary_slots;
+
+            template <size_t Index>
+            game_value nular_stub(game_state& state_) {
+                auto function = nular_slots[Index].resolve();
+                return function ? function(state_) : game_value();
+            }
+
+            template <size_t Index>
+            game_value unary_stub(game_state& state_, game_value_parameter right_) {
+                auto function = unary_slots[Index].resolve();
+                return function ? function(state_, right_) : game_value();
+            }
+
+            template <size_t Index>
+            game_value binary_stub(game_state& state_, game_value_parameter left_, game_value_parameter right_) {
+                auto function = binary_slots[Index].resolve();
+                return function ? function(state_, left_, right_) : game_value();
+            }
+
+            template <size_t... Indices>
+            constexpr std::array<nular_function, sizeof...(Indices)> make_nular_stubs(std::index_sequence<Indices...>) {
+                return {&nular_stub<Indices>...};
+            }
+
+            template <size_t... Indices>
+            constexpr std::array<unary_function, sizeof...(Indices)> make_unary_stubs(std::index_sequence<Indices...>) {
+                return {&unary_stub<Indices>...};
+            }
+
+            template <size_t... Indices>
+            constexpr std::array<binary_function, sizeof...(Indices)> make_binary_stubs(std::index_sequence<Indices...>) {
+                return {&binary_stub<Indices>...};
+            }
+
+            const auto nular_stubs = make_nular_stubs(std::make_index_sequence<nular_capacity>());
+            const auto unary_stubs = make_unary_stubs(std::make_index_sequence<unary_capacity>());
+            const auto binary_stubs = make_binary_stubs(std::make_index_sequence<binary_capacity>());
+
+            /*!
+            @brief Stands in for host::functions while sqf_assignments.hpp runs.
+
+            Records the requested name and types and returns a stub for them. If the
+            stubs run out it falls back to resolving right away.
+            */
+            class lazy_functions {
+            public:
+                void reset() {
+                    _nular_count = _unary_count = _binary_count = 0;
+                    for (auto& slot : nular_slots) slot.resolved = false;
+                    for (auto& slot : unary_slots) slot.resolved = false;
+                    for (auto& slot : binary_slots) slot.resolved = false;
+                }
+
+                nular_function get_nular_function(std::string_view name_) {
+                    if (_nular_count == nular_capacity) return intercept::client::host::functions.get_nular_function(name_);
+                    nular_slots[_nular_count].name = name_;
+                    return nular_stubs[_nular_count++];
+                }
+
+                unary_function get_unary_function_typed(std::string_view name_, std::string_view right_type_) {
+                    if (_unary_count == unary_capacity) return intercept::client::host::functions.get_unary_function_typed(name_, right_type_);
+                    unary_slots[_unary_count].name = name_;
+                    unary_slots[_unary_count].right_type = right_type_;
+                    return unary_stubs[_unary_count++];
+                }
+
+                binary_function get_binary_function_typed(std::string_view name_, std::string_view left_type_, std::string_view right_type_) {
+                    if (_binary_count == binary_capacity) return intercept::client::host::functions.get_binary_function_typed(name_, left_type_, right_type_);
+                    binary_slots[_binary_count].name = name_;
+                    binary_slots[_binary_count].left_type = left_type_;
+                    binary_slots[_binary_count].right_type = right_type_;
+                    return binary_stubs[_binary_count++];
+                }
+
+            private:
+                size_t _nular_count{0};
+                size_t _unary_count{0};
+                size_t _binary_count{0};
+            };
+
+            //Shadows intercept::client::host inside this namespace, so the generated assignments hand out stubs
+            namespace host {
+                lazy_functions functions;
+            }
+
+            void initialize() {
+                host::functions.reset();
+#include "sqf_assignments.hpp"
+                __sqf::binary__configaccessor__config__string__ret__config = host::functions.get_binary_function_typed(">>"sv, "CONFIG"sv, "STRING"sv);
+            }
+        }
+
+        void __sqf::__initialize()
+        {
+            __lazy_sqf::initialize();
+        }
+    #endif
     }
 
-    
+
 }
 #endif
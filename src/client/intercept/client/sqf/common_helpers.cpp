@@ -136,6 +136,28 @@ namespace intercept {
             object __object_unary_object(unary_function fnc_, const object& obj_) {
                 return object(host::functions.invoke_raw_unary(fnc_, obj_));
             }
+
+            //results_ keeps its capacity, so calling these every frame with the same buffers doesn't allocate on our side
+            void __vector3_unary_objects(unary_function fnc_, const std::vector<object>& objects_, std::vector<vector3>& results_) {
+                results_.resize(objects_.size());
+                client::invoker_lock lock;
+                for (size_t i = 0; i < objects_.size(); ++i)
+                    results_[i] = host::functions.invoke_raw_unary(fnc_, objects_[i]);
+            }
+
+            void __number_unary_objects(unary_function fnc_, const std::vector<object>& objects_, std::vector<float>& results_) {
+                results_.resize(objects_.size());
+                client::invoker_lock lock;
+                for (size_t i = 0; i < objects_.size(); ++i)
+                    results_[i] = host::functions.invoke_raw_unary(fnc_, objects_[i]);
+            }
+
+            void __bool_unary_objects(unary_function fnc_, const std::vector<object>& objects_, std::vector<bool>& results_) {
+                results_.resize(objects_.size());
+                client::invoker_lock lock;
+                for (size_t i = 0; i < objects_.size(); ++i)
+                    results_[i] = static_cast<bool>(host::functions.invoke_raw_unary(fnc_, objects_[i]));
+            }
         }  // namespace __helpers
     }      // namespace sqf
 }  // namespace intercept
@@ -65,6 +65,10 @@ namespace intercept {
             return host::functions.invoke_raw_unary(__sqf::unary__configname__config__ret__string, config_entry_);
         }
 
+        r_string config_name_raw(const config &config_entry_) {
+            return host::functions.invoke_raw_unary(__sqf::unary__configname__config__ret__string, config_entry_);
+        }
+
         std::vector<config> config_properties(const config &config_entry, sqf_string_const_ref condition_, bool inherit) {
             game_value array_entry({config_entry,
                                     condition_,
@@ -98,6 +102,10 @@ namespace intercept {
             return host::functions.invoke_raw_unary(__sqf::unary__gettext__config__ret__string, config_entry_);
         }
 
+        r_string get_text_raw(const config &config_entry_) {
+            return host::functions.invoke_raw_unary(__sqf::unary__gettext__config__ret__string, config_entry_);
+        }
+
         config inherits_from(const config &config_entry_) {
             return config(host::functions.invoke_raw_unary(__sqf::unary__inheritsfrom__config__ret__config, config_entry_));
         }
@@ -203,5 +211,9 @@ namespace intercept {
             return __helpers::__string_unary_object(__sqf::unary__typeof__object__ret__string, value_);
         }
 
+        r_string type_of_raw(const object &value_) {
+            return host::functions.invoke_raw_unary(__sqf::unary__typeof__object__ret__string, value_);
+        }
+
     }  // namespace sqf
 }  // namespace intercept
@@ -50,33 +50,36 @@ namespace intercept {
         }
 
         intersect_surfaces_list line_intersects_surfaces(const vector3 &begin_pos_asl_, const vector3 &end_pos_asl_) {
-            game_value array_input({begin_pos_asl_,
-                                    end_pos_asl_});
+            static game_value_builder array_input(2);
+            array_input.begin().add(begin_pos_asl_).add(end_pos_asl_);
 
-            game_value intersects_value = host::functions.invoke_raw_unary(__sqf::unary__lineintersectssurfaces__array__ret__array, array_input);
+            game_value intersects_value = host::functions.invoke_raw_unary(__sqf::unary__lineintersectssurfaces__array__ret__array, array_input.get());
             return __helpers::__line_intersects_surfaces(intersects_value);
         }
 
         intersect_surfaces_list line_intersects_surfaces(const vector3 &begin_pos_asl_, const vector3 &end_pos_asl_, const object &ignore_obj1_) {
-            game_value array_input({begin_pos_asl_,
-                                    end_pos_asl_,
-                                    ignore_obj1_});
+            static game_value_builder array_input(3);
+            array_input.begin().add(begin_pos_asl_).add(end_pos_asl_).add(ignore_obj1_);
 
-            game_value intersects_value = host::functions.invoke_raw_unary(__sqf::unary__lineintersectssurfaces__array__ret__array, array_input);
+            game_value intersects_value = host::functions.invoke_raw_unary(__sqf::unary__lineintersectssurfaces__array__ret__array, array_input.get());
+            array_input.release();
             return __helpers::__line_intersects_surfaces(intersects_value);
         }
 
         intersect_surfaces_list line_intersects_surfaces(const vector3 &begin_pos_asl_, const vector3 &end_pos_asl_, const object &ignore_obj1_, const object &ignore_obj2_, bool sort_mode_, int max_results_, sqf_string_const_ref lod1_, sqf_string_const_ref lod2_) {
-            game_value array_input = game_value({begin_pos_asl_,
-                                                 end_pos_asl_,
-                                                 ignore_obj1_,
-                                                 ignore_obj2_,
-                                                 sort_mode_,
-                                                 static_cast<float>(max_results_),
-                                                 lod1_,
-                                                 lod2_});
-
-            game_value intersects_value = host::functions.invoke_raw_unary(__sqf::unary__lineintersectssurfaces__array__ret__array, array_input);
+            static game_value_builder array_input(8);
+            array_input.begin()
+                .add(begin_pos_asl_)
+                .add(end_pos_asl_)
+                .add(ignore_obj1_)
+                .add(ignore_obj2_)
+                .add(sort_mode_)
+                .add(static_cast<float>(max_results_))
+                .add(game_value(lod1_))
+                .add(game_value(lod2_));
+
+            game_value intersects_value = host::functions.invoke_raw_unary(__sqf::unary__lineintersectssurfaces__array__ret__array, array_input.get());
+            array_input.release();
             return __helpers::__line_intersects_surfaces(intersects_value);
         }
 
@@ -114,29 +117,30 @@ namespace intercept {
         }
 
         bool terrain_intersect(const vector3 &begin_pos_, const vector3 &end_pos_) {
-            game_value array_input({begin_pos_,
-                                    end_pos_});
+            static game_value_builder array_input(2);
+            array_input.begin().add(begin_pos_).add(end_pos_);
 
-            return host::functions.invoke_raw_unary(__sqf::unary__terrainintersect__array__ret__bool, array_input);
+            return host::functions.invoke_raw_unary(__sqf::unary__terrainintersect__array__ret__bool, array_input.get());
         }
 
         bool terrain_intersect_asl(const vector3 &begin_pos_, const vector3 &end_pos_) {
-            game_value array_input({begin_pos_,
-                                    end_pos_});
-            return host::functions.invoke_raw_unary(__sqf::unary__terrainintersectasl__array__ret__bool, array_input);
+            static game_value_builder array_input(2);
+            array_input.begin().add(begin_pos_).add(end_pos_);
+            return host::functions.invoke_raw_unary(__sqf::unary__terrainintersectasl__array__ret__bool, array_input.get());
         }
 
         bool line_intersects(const vector3 &begin_position_, const vector3 &end_position_) {
-            game_value array_input({begin_position_,
-                                    end_position_});
-            return host::functions.invoke_raw_unary(__sqf::unary__lineintersects__array__ret__bool, array_input);
+            static game_value_builder array_input(2);
+            array_input.begin().add(begin_position_).add(end_position_);
+            return host::functions.invoke_raw_unary(__sqf::unary__lineintersects__array__ret__bool, array_input.get());
         }
 
         bool line_intersects(const vector3 &begin_position_, const vector3 &end_position_, const object &ignore_obj_one_) {
-            game_value array_input({begin_position_,
-                                    end_position_,
-                                    ignore_obj_one_});
-            return host::functions.invoke_raw_unary(__sqf::unary__lineintersects__array__ret__bool, array_input);
+            static game_value_builder array_input(3);
+            array_input.begin().add(begin_position_).add(end_position_).add(ignore_obj_one_);
+            const bool intersects = host::functions.invoke_raw_unary(__sqf::unary__lineintersects__array__ret__bool, array_input.get());
+            array_input.release();
+            return intersects;
         }
 
         bool line_intersects(const vector3 &begin_position_, const vector3 &end_position_, const object &ignore_obj_one_, const object &ignore_obj_two_) {
@@ -152,6 +152,30 @@ namespace intercept {
             return host::functions.invoke_raw_unary(__sqf::unary__getposworld__object__ret__array, unit_);
         }
 
+        void get_pos(const std::vector<object> &objects_, std::vector<vector3> &results_) {
+            __helpers::__vector3_unary_objects(__sqf::unary__getpos__object__ret__array, objects_, results_);
+        }
+
+        void get_pos_asl(const std::vector<object> &objects_, std::vector<vector3> &results_) {
+            __helpers::__vector3_unary_objects(__sqf::unary__getposasl__object__ret__array, objects_, results_);
+        }
+
+        void get_pos_atl(const std::vector<object> &objects_, std::vector<vector3> &results_) {
+            __helpers::__vector3_unary_objects(__sqf::unary__getposatl__object__ret__array, objects_, results_);
+        }
+
+        void get_pos_world(const std::vector<object> &objects_, std::vector<vector3> &results_) {
+            __helpers::__vector3_unary_objects(__sqf::unary__getposworld__object__ret__array, objects_, results_);
+        }
+
+        void velocity(const std::vector<object> &objects_, std::vector<vector3> &results_) {
+            __helpers::__vector3_unary_objects(__sqf::unary__velocity__object__ret__array, objects_, results_);
+        }
+
+        void get_dir(const std::vector<object> &objects_, std::vector<float> &results_) {
+            __helpers::__number_unary_objects(__sqf::unary__getdir__object__ret__scalar, objects_, results_);
+        }
+
         float get_terrain_height_asl(vector3 position_) {
             return host::functions.invoke_raw_unary(__sqf::unary__getterrainheightasl__array__ret__scalar, position_);
         }
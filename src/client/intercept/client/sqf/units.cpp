@@ -17,33 +17,23 @@ namespace intercept {
         }
 
         void targets(const object &unit_, std::optional<bool> enemy_only_, std::optional<float> max_distance_, std::optional<std::vector<side>> sides_, std::optional<float> max_age_, std::optional<std::variant<std::reference_wrapper<vector2>, std::reference_wrapper<vector3>>> alternate_center_) {
-            auto_array<game_value> params_right;
-
-            if (enemy_only_.has_value())
-                params_right.push_back(*enemy_only_);
-            else
-                params_right.push_back(game_value());
-            if (max_distance_.has_value())
-                params_right.push_back(*max_distance_);
-            else
-                params_right.push_back(game_value());
+            static game_value_builder params_right(5);
+            params_right.begin().add(enemy_only_).add(max_distance_);
             if (sides_.has_value())
-                params_right.push_back(auto_array<game_value>((*sides_).begin(), (*sides_).end()));
-            else
-                params_right.push_back(game_value());
-            if (max_age_.has_value())
-                params_right.push_back(*max_age_);
+                params_right.add(game_value(auto_array<game_value>((*sides_).begin(), (*sides_).end())));
             else
-                params_right.push_back(game_value());
+                params_right.add_nil();
+            params_right.add(max_age_);
             if (alternate_center_.has_value()) {
                 if ((*alternate_center_).index() == 0)
-                    params_right.push_back(std::get<0>(*alternate_center_).get());
+                    params_right.add(std::get<0>(*alternate_center_).get());
                 else
-                    params_right.push_back(std::get<1>(*alternate_center_).get());
+                    params_right.add(std::get<1>(*alternate_center_).get());
             } else
-                params_right.push_back(game_value());
+                params_right.add_nil();
 
-            host::functions.invoke_raw_binary(__sqf::binary__targets__object__array__ret__array, unit_, std::move(params_right));
+            host::functions.invoke_raw_binary(__sqf::binary__targets__object__array__ret__array, unit_, params_right.get());
+            params_right.release();
         }
 
         bool is_uav_connectable(const object &unit_, const object &uav_, bool check_all_items_) {
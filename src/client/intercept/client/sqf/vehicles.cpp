@@ -246,6 +246,10 @@ namespace intercept {
             return __helpers::__bool_unary_object(__sqf::unary__alive__object__ret__bool, obj_);
         }
 
+        void alive(const std::vector<object> &objects_, std::vector<bool> &results_) {
+            __helpers::__bool_unary_objects(__sqf::unary__alive__object__ret__bool, objects_, results_);
+        }
+
         object assigned_commander(const object &veh_) {
             return __helpers::__object_unary_object(__sqf::unary__assignedcommander__object__ret__object, veh_);
         }
@@ -274,6 +278,10 @@ namespace intercept {
             return __helpers::__number_unary_object(__sqf::unary__damage__object__ret__scalar, object_);
         }
 
+        void damage(const std::vector<object> &objects_, std::vector<float> &results_) {
+            __helpers::__number_unary_objects(__sqf::unary__damage__object__ret__scalar, objects_, results_);
+        }
+
         object driver(const object &value_) {
             return __helpers::__object_unary_object(__sqf::unary__driver__object__ret__object, value_);
         }
@@ -2,6 +2,11 @@
 #include "client/client.hpp"
 #include "shared/functions.hpp"
 #include "../client/sqf/common_helpers.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+#include <thread>
 
 namespace intercept::types {
     internal_object::internal_object() : game_value() {}
@@ -84,13 +89,105 @@ namespace intercept::types {
     }
 
 
-    static std::vector<ref<game_data>> gv_threadsafe_garbage;
-    static std::mutex gv_threadsafe_garbage_lock;
+    namespace {
+        //Garbage of one thread. The thread only appends to the active list. garbage_collect switches the active
+        //list and takes the other one once the thread isn't in the middle of an append, so neither side locks.
+        struct gv_garbage_buffer {
+            std::vector<ref<game_data>> lists[2];
+            std::atomic<uint32_t> active{0};
+            std::atomic_bool appending{false};
+            std::atomic<uint64_t> discarded{0};
+        };
+
+        struct gv_garbage_registry {
+            //Taken when a thread discards for the first time or exits, and by garbage_collect. Never while appending.
+            std::mutex lock;
+            std::vector<gv_garbage_buffer*> buffers;
+            //Left behind by exited threads
+            std::vector<ref<game_data>> orphaned;
+            uint64_t orphaned_discarded = 0;
+
+            //Only touched by garbage_collect
+            std::mutex collect_lock;
+            std::vector<ref<game_data>> collecting;
+            std::atomic<uint64_t> collected{0};
+            std::atomic<size_t> peak_pending{0};
+        };
+
+        //Never destroyed, thread_local buffers of threads that exit late still need it
+        gv_garbage_registry& gv_garbage() {
+            static auto registry = new gv_garbage_registry();
+            return *registry;
+        }
+
+        struct gv_thread_garbage {
+            gv_garbage_buffer buffer;
+
+            gv_thread_garbage() {
+                auto& registry = gv_garbage();
+                std::lock_guard<std::mutex> lock(registry.lock);
+                registry.buffers.push_back(&buffer);
+            }
+            ~gv_thread_garbage() {
+                auto& registry = gv_garbage();
+                std::lock_guard<std::mutex> lock(registry.lock);
+                registry.buffers.erase(std::find(registry.buffers.begin(), registry.buffers.end(), &buffer));
+                for (auto& list : buffer.lists)
+                    std::move(list.begin(), list.end(), std::back_inserter(registry.orphaned));
+                registry.orphaned_discarded += buffer.discarded.load(std::memory_order_relaxed);
+            }
+        };
+
+        thread_local gv_thread_garbage gv_thread_local_garbage;
+    }  // namespace
 
     void game_value_threadsafe::garbage_collect() {
-        std::unique_lock<std::mutex> lock(gv_threadsafe_garbage_lock);
-        client::invoker_lock invoke_lock;
-        gv_threadsafe_garbage.clear();
+        auto& registry = gv_garbage();
+        std::lock_guard<std::mutex> collect_lock(registry.collect_lock);
+        {
+            //Moving refs doesn't touch the engine, so this doesn't need the invoker lock. Not holding the registry
+            //lock while waiting for the invoker also means threads that hold the invoker can still register.
+            std::lock_guard<std::mutex> lock(registry.lock);
+            for (auto buffer : registry.buffers) {
+                const auto previous = buffer->active.load(std::memory_order_relaxed);
+                buffer->active.store(previous ^ 1);
+                //An append that started before the switch might still be writing to the previous list
+                while (buffer->appending.load()) std::this_thread::yield();
+
+                auto& list = buffer->lists[previous];
+                std::move(list.begin(), list.end(), std::back_inserter(registry.collecting));
+                list.clear();
+            }
+            std::move(registry.orphaned.begin(), registry.orphaned.end(), std::back_inserter(registry.collecting));
+            registry.orphaned.clear();
+        }
+        if (registry.collecting.empty()) return;
+
+        const auto released = registry.collecting.size();
+        {
+            client::invoker_lock invoke_lock;
+            registry.collecting.clear();
+        }
+        registry.collected.fetch_add(released, std::memory_order_relaxed);
+        if (released > registry.peak_pending.load(std::memory_order_relaxed))
+            registry.peak_pending.store(released, std::memory_order_relaxed);
+    }
+
+    game_value_threadsafe::garbage_stats game_value_threadsafe::garbage_statistics() {
+        auto& registry = gv_garbage();
+        std::lock_guard<std::mutex> lock(registry.lock);
+        uint64_t discarded = registry.orphaned_discarded;
+        for (auto buffer : registry.buffers)
+            discarded += buffer->discarded.load(std::memory_order_relaxed);
+        const auto collected = registry.collected.load(std::memory_order_relaxed);
+
+        garbage_stats stats;
+        //A collect that is running right now might already count values that aren't released yet
+        stats.pending = discarded > collected ? static_cast<size_t>(discarded - collected) : 0;
+        stats.peak_pending = registry.peak_pending.load(std::memory_order_relaxed);
+        stats.collected = collected;
+        stats.threads = registry.buffers.size();
+        return stats;
     }
 
     game_value_threadsafe::~game_value_threadsafe() {
@@ -207,9 +304,135 @@ namespace intercept::types {
         //Don't need to store data that won't get deleted anyway.
         //But we also don't want to get into race-condition area. Number 5 was choosen by a fair dice roll.
         if (data.ref_count() < 5) {
-            std::unique_lock<std::mutex> lock(gv_threadsafe_garbage_lock);
-            gv_threadsafe_garbage.emplace_back(std::move(data));
+            auto& buffer = gv_thread_local_garbage.buffer;
+            //Sequentially consistent, so garbage_collect either sees us appending or we see its switch
+            buffer.appending.store(true);
+            buffer.lists[buffer.active.load()].emplace_back(std::move(data));
+            buffer.appending.store(false, std::memory_order_release);
+            buffer.discarded.store(buffer.discarded.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+
+}
+
+namespace intercept::types {
+    namespace {
+        //Only we hold a reference, so nobody can observe the change
+        bool is_exclusive(const game_value& value_, uintptr_t type_) {
+            return value_.data && value_.data.ref_count() == 1 && value_.type() == type_;
+        }
+    }
+
+    game_value_builder& game_value_builder::begin() {
+        _cursor = 0;
+        if (is_exclusive(_array, game_data_array::type_def)) return *this;
+
+        //The engine or the caller kept the last array, start a new one
+        auto_array<game_value> elements;
+        elements.reserve(_reserve);
+        _array = game_value(std::move(elements));
+        ++_created;
+        return *this;
+    }
+
+    game_value& game_value_builder::next_slot() {
+        auto& elements = static_cast<game_data_array*>(_array.data.get())->data;
+        if (_cursor == elements.size()) elements.emplace_back();
+        return elements[_cursor++];
+    }
+
+    bool game_value_builder::set_numbers(game_value& slot_, const float* values_, size_t count_) {
+        if (!is_exclusive(slot_, game_data_array::type_def)) return false;
+        auto& elements = static_cast<game_data_array*>(slot_.data.get())->data;
+        if (elements.size() != count_) return false;
+        for (auto& element : elements) {
+            if (!is_exclusive(element, game_data_number::type_def)) return false;
+        }
+        for (size_t i = 0; i < count_; ++i)
+            static_cast<game_data_number*>(elements[i].data.get())->number = values_[i];
+        return true;
+    }
+
+    game_value_builder& game_value_builder::add(float val_) {
+        auto& slot = next_slot();
+        if (is_exclusive(slot, game_data_number::type_def)) {
+            static_cast<game_data_number*>(slot.data.get())->number = val_;
+        } else {
+            slot = val_;
+            ++_created;
+        }
+        return *this;
+    }
+
+    game_value_builder& game_value_builder::add(bool val_) {
+        auto& slot = next_slot();
+        if (is_exclusive(slot, game_data_bool::type_def)) {
+            static_cast<game_data_bool*>(slot.data.get())->val = val_;
+        } else {
+            slot = val_;
+            ++_created;
+        }
+        return *this;
+    }
+
+    game_value_builder& game_value_builder::add(const vector3& vec_) {
+        auto& slot = next_slot();
+        const float values[] = {vec_.x, vec_.y, vec_.z};
+        if (!set_numbers(slot, values, 3)) {
+            slot = vec_;
+            _created += 4;
+        }
+        return *this;
+    }
+
+    game_value_builder& game_value_builder::add(const vector2& vec_) {
+        auto& slot = next_slot();
+        const float values[] = {vec_.x, vec_.y};
+        if (!set_numbers(slot, values, 2)) {
+            slot = vec_;
+            _created += 3;
+        }
+        return *this;
+    }
+
+    game_value_builder& game_value_builder::add(const game_value& val_) {
+        next_slot() = val_;
+        return *this;
+    }
+
+    game_value_builder& game_value_builder::add(game_value&& val_) {
+        next_slot() = std::move(val_);
+        return *this;
+    }
+
+    game_value_builder& game_value_builder::add_nil() {
+        next_slot().clear();
+        return *this;
+    }
+
+    const game_value& game_value_builder::get() {
+        auto& elements = static_cast<game_data_array*>(_array.data.get())->data;
+        if (_cursor != elements.size()) {
+            //Fewer elements than last time. auto_array can't shrink in place, so copy the used part
+            _array = game_value(auto_array<game_value>(elements.begin(), elements.begin() + _cursor));
+            ++_created;
         }
+        return _array;
     }
 
+    void game_value_builder::release() {
+        if (!is_exclusive(_array, game_data_array::type_def)) {
+            _array.clear();
+            return;
+        }
+        for (auto& element : static_cast<game_data_array*>(_array.data.get())->data) {
+            const auto type = element.type();
+            if (type == game_data_number::type_def || type == game_data_bool::type_def) continue;
+            if (type == game_data_array::type_def) {
+                auto& numbers = static_cast<game_data_array*>(element.data.get())->data;
+                if (std::all_of(numbers.begin(), numbers.end(), [](const game_value& number_) { return number_.type() == game_data_number::type_def; })) continue;
+            }
+            element.clear();
+        }
+    }
 }
@@ -2,93 +2,157 @@
 
 #include "shared.hpp"
 
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
 #include <vector>
 #include <string>
+#include <string_view>
 
 namespace intercept {
+    /*!
+    @brief Converts trimmed argument tokens to numbers without going through a stream.
+
+    Like atoi, a leading + is accepted, trailing garbage is ignored and anything
+    that doesn't start with a number is 0.
+    */
+    struct argument_parser {
+        static std::string_view trim(std::string_view val_) noexcept {
+            while (!val_.empty() && std::isspace(static_cast<unsigned char>(val_.front()))) val_.remove_prefix(1);
+            while (!val_.empty() && std::isspace(static_cast<unsigned char>(val_.back()))) val_.remove_suffix(1);
+            return val_;
+        }
+
+        static float to_float(std::string_view val_) noexcept {
+            if (!val_.empty() && val_.front() == '+') val_.remove_prefix(1);
+        #if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            float res = 0.0f;
+            std::from_chars(val_.data(), val_.data() + val_.size(), res);
+            return res;
+        #else
+            //Floating point from_chars needs libstdc++ 11. strtof needs a terminated copy, no float is longer than the buffer
+            char buffer[64];
+            if (val_.size() >= sizeof(buffer)) return 0.0f;
+            std::memcpy(buffer, val_.data(), val_.size());
+            buffer[val_.size()] = '\0';
+            return std::strtof(buffer, nullptr);
+        #endif
+        }
+
+        static int to_int(std::string_view val_) noexcept {
+            if (!val_.empty() && val_.front() == '+') val_.remove_prefix(1);
+            int res = 0;
+            std::from_chars(val_.data(), val_.data() + val_.size(), res);
+            return res;
+        }
+    };
+
+    class arguments;
+
     class argument_accessor {
     public:
-        argument_accessor(const uint32_t index, const std::vector<std::string> & ar) noexcept : _index(index), _args(ar) { }
+        argument_accessor(const uint32_t index, const arguments & ar) noexcept : _index(index), _args(ar) { }
 
-        const std::string & as_string() const { return _args[_index]; }
-        operator const std::string &() const { return as_string(); }
+        std::string_view as_string() const noexcept;
+        operator std::string_view() const noexcept { return as_string(); }
 
-        static float to_float(const std::string & val) { float res = 0.0f; std::istringstream iss(val); iss >> res; return res; }
-        float as_float() const { return to_float(_args[_index]); }
-        operator float() const { return as_float(); }
+        float as_float() const noexcept { return argument_parser::to_float(as_string()); }
+        operator float() const noexcept { return as_float(); }
 
-        int as_int() const { return atoi(_args[_index].c_str()); }
-        operator int() const { return as_int(); }
+        int as_int() const noexcept { return argument_parser::to_int(as_string()); }
+        operator int() const noexcept { return as_int(); }
 
-        int as_uint32() const { return static_cast<uint32_t>(atoi(_args[_index].c_str())); }
-        operator uint32_t() const { return as_uint32(); }
+        uint32_t as_uint32() const noexcept { return static_cast<uint32_t>(as_int()); }
+        operator uint32_t() const noexcept { return as_uint32(); }
 
     protected:
-        const uint32_t                      _index;
-        const std::vector<std::string> &    _args;
+        const uint32_t      _index;
+        const arguments &   _args;
     };
 
+    /*!
+    @brief Comma separated callExtension arguments.
+
+    The arguments are trimmed views into the string they were parsed from, so
+    that string has to outlive the arguments. The first inline_capacity of them
+    are kept inline, which means the usual short calls never allocate.
+    */
     class arguments {
     public:
-        arguments(const std::string & str) : _original(str), _internal_index(0) {
-            _args = intercept::split(str, ',');
-            for (uint32_t i = 0; i < _args.size(); i++) {
-                _args[i] = trim(_args[i]);
+        static constexpr size_t inline_capacity = 16;
+
+        arguments(std::string_view str) : _original(str), _internal_index(0) {
+            //Same tokens as splitting with std::getline, an empty input or a trailing , add no empty argument
+            size_t start = 0;
+            while (start < str.length()) {
+                auto end = str.find(',', start);
+                if (end == std::string_view::npos) end = str.length();
+                push(argument_parser::trim(str.substr(start, end - start)));
+                start = end + 1;
             }
         }
-        //#TODO string_view implementation
-        //arguments(std::string_view str) : _original(std::string(str)), _internal_index(0) {
-        //    _args = intercept::split(str, ',');
-        //    for (uint32_t i = 0; i < _args.size(); i++) {
-        //        _args[i] = trim(_args[i]);
-        //    }
-        //}
-
-        size_t size() const noexcept { return _args.size(); }
+        arguments(const arguments &) = delete;
+        arguments & operator=(const arguments &) = delete;
 
-        const argument_accessor operator[] (int index) const noexcept { return argument_accessor(index, _args); }
-        //argument_accessor operator[] (int index) const { return argument_accessor(index, _args); }
+        size_t size() const noexcept { return _size; }
 
+        const argument_accessor operator[] (int index) const noexcept { return argument_accessor(index, *this); }
 
-        static float to_float(const std::string & val) { float res = 0.0f; std::istringstream iss(val); iss >> res; return res; }
+        static float to_float(std::string_view val) noexcept { return argument_parser::to_float(val); }
 
-        const std::string & as_string() { return _args[_internal_index++]; }
-        float as_float() { return to_float(_args[_internal_index++]); }
-        int as_int() { return atoi(_args[_internal_index++].c_str()); }
-        int as_uint32() { return static_cast<uint32_t>(atoi(_args[_internal_index++].c_str())); }
+        std::string_view as_string() noexcept { return as_string(_internal_index++); }
+        float as_float() noexcept { return to_float(as_string()); }
+        int as_int() noexcept { return argument_parser::to_int(as_string()); }
+        uint32_t as_uint32() noexcept { return static_cast<uint32_t>(as_int()); }
 
-        const std::string & as_string(uint32_t _index) const { return _args[_index]; }
-        float as_float(uint32_t _index) const { return to_float(_args[_index]); }
-        int as_int(uint32_t _index) const { return atoi(_args[_index].c_str()); }
-        int as_uint32(uint32_t _index) const { return static_cast<uint32_t>(atoi(_args[_index].c_str())); }
+        std::string_view as_string(uint32_t _index) const noexcept {
+            if (_index < inline_capacity) return _inline_args[_index];
+            return _index < _size ? _spilled_args[_index - inline_capacity] : std::string_view();
+        }
+        float as_float(uint32_t _index) const noexcept { return to_float(as_string(_index)); }
+        int as_int(uint32_t _index) const noexcept { return argument_parser::to_int(as_string(_index)); }
+        uint32_t as_uint32(uint32_t _index) const noexcept { return static_cast<uint32_t>(as_int(_index)); }
 
 
-        const std::string & get() const noexcept {
+        std::string_view get() const noexcept {
             return _original;
         }
 
-        std::string create(const std::string & command) const {
-            std::stringstream ss;
-            ss << command << ":";
+        std::string create(std::string_view command) const {
+            std::string result;
+            result.reserve(command.length() + _original.length() + _size + 1);
+            result.append(command).append(":");
 
-            for (auto & v : _args) {
-                ss << v << ",";
+            for (size_t i = 0; i < _size; ++i) {
+                result.append(as_string(static_cast<uint32_t>(i))).append(",");
             }
 
-            // Remove the trailing ,
-            std::string result = ss.str();
-            result.erase(result.length());
-
             return result;
         }
-        static std::string create(const std::string & command, const arguments & args) {
+        static std::string create(std::string_view command, const arguments & args) {
             return args.create(command);
         }
-        
+
 
     protected:
-        std::vector<std::string> _args;
-        const std::string        _original;
-        uint32_t                 _internal_index;
+        void push(std::string_view arg_) {
+            if (_size < inline_capacity)
+                _inline_args[_size] = arg_;
+            else
+                _spilled_args.push_back(arg_);
+            ++_size;
+        }
+
+        std::array<std::string_view, inline_capacity> _inline_args;
+        std::vector<std::string_view>   _spilled_args;
+        size_t                          _size = 0;
+        const std::string_view          _original;
+        uint32_t                        _internal_index;
     };
+
+    inline std::string_view argument_accessor::as_string() const noexcept {
+        return _args.as_string(_index);
+    }
 }
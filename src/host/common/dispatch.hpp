@@ -4,10 +4,16 @@
 #include <mutex>
 #include <atomic>
 #include <queue>
+#include <condition_variable>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <string_view>
 
 #include "shared.hpp"
 #include "arguments.hpp"
 #include "singleton.hpp"
+#include "mpsc_queue.hpp"
 #include <chrono>
 using namespace std::literals::chrono_literals;
 namespace intercept {
@@ -30,41 +36,91 @@ namespace intercept {
         bool _stopped;
     };
 
+    /*!
+    @brief Fixed size table of the commands a dispatcher knows.
+
+    Commands are only added while the host starts up, a lookup on the
+    callExtension path hashes the name once and probes a few slots, without
+    allocating. The names are not copied, they have to be string literals.
+    */
+    class command_table {
+    public:
+        using handler = std::function<bool(arguments &, std::string &)>;
+
+        ///Only half of the slots are used, which keeps the probe sequences short
+        static constexpr size_t capacity = 128;
+
+        bool add(std::string_view name_, handler func_) {
+            if (_count >= capacity / 2) return false;
+            for (size_t i = hash(name_);; i = (i + 1) & (capacity - 1)) {
+                auto& slot = _slots[i];
+                if (!slot.func) {
+                    slot.name = name_;
+                    slot.func = std::move(func_);
+                    ++_count;
+                    return true;
+                }
+                if (slot.name == name_) return false;
+            }
+        }
+
+        const handler* find(std::string_view name_) const noexcept {
+            for (size_t i = hash(name_);; i = (i + 1) & (capacity - 1)) {
+                auto& slot = _slots[i];
+                if (!slot.func) return nullptr;
+                if (slot.name == name_) return &slot.func;
+            }
+        }
+
+    private:
+        struct slot {
+            std::string_view name;
+            handler func;
+        };
+
+        static size_t hash(std::string_view name_) noexcept {
+            uint32_t hash = 2166136261u;
+            for (const auto character : name_) {
+                hash ^= static_cast<uint8_t>(character);
+                hash *= 16777619u;
+            }
+            return hash & (capacity - 1);
+        }
+
+        std::array<slot, capacity> _slots;
+        size_t _count = 0;
+    };
+
     class dispatcher {
     public:
         dispatcher() noexcept : _ready(true) { }
 
         virtual bool call(const std::string_view name_, arguments & args_, std::string & result_) {
             auto method = _methods.find(name_);
-            if (method != _methods.end()) {
-                return method->second(args_, result_);
+            if (method) {
+                return (*method)(args_, result_);
             }
             return false;
         }
 
         bool add(const std::string_view name_, std::function<bool(arguments &, std::string &)> func_) {
-            if (_methods.find(name_) != _methods.end()) {
-                // @TODO: Exceptions
-                return false;
-            }
-            _methods[name_] = func_;
-
-            return true;
+            // @TODO: Exceptions
+            return _methods.add(name_, std::move(func_));
         }
         
         bool ready() const noexcept { return _ready;  }
         void ready(bool r) noexcept { _ready.exchange(r); }
     protected:
-        std::unordered_map < std::string_view, std::function<bool(arguments &, std::string &)> > _methods;
+        command_table _methods;
         std::atomic_bool _ready;
     };
     class dispatch : public dispatcher, public singleton<dispatch> { };
 
     struct dispatch_message {
-        dispatch_message(std::string_view command_, const arguments & args_, const uint64_t id_) : command(command_), args(args_), id(id_) {}
+        dispatch_message(std::string_view command_, const arguments & args_, const uint64_t id_) : command(command_), args(args_.get()), id(id_) {}
         std::string command;
-        arguments args;
-        uint64_t    id;
+        std::string args; //arguments only view their input, the queued copy owns it
+        uint64_t    id{};
     };
     struct dispatch_result {
         dispatch_result() noexcept {}
@@ -73,37 +129,70 @@ namespace intercept {
         uint64_t    id{};
     };
 
+    /*!
+    @brief Dispatcher that can also run commands on a pool of worker threads.
+
+    Threaded commands are queued and picked up by the first free worker, so one
+    long running command doesn't hold up the others when more than one worker
+    is used. Workers sleep on a condition variable while there is nothing to do.
+    Results are handed back through a lock free queue that is emptied by
+    fetch_result on the game thread.
+    */
     class threaded_dispatcher : public dispatcher {
     public:
-        threaded_dispatcher() noexcept : _stop(false), _message_id(0) {
+        /*!
+        @param worker_count_ Number of worker threads, started with the first threaded call.
+        */
+        explicit threaded_dispatcher(size_t worker_count_ = 1) noexcept : _stop(false), _message_id(0), _worker_count(worker_count_ ? worker_count_ : 1) {
  
         }
 
-        virtual ~threaded_dispatcher() {}
+        virtual ~threaded_dispatcher() {
+            stop();
+            join_workers();
+        }
+
+        /*!
+        @brief Sets the number of worker threads. Workers that are already running are not stopped, so a started pool only grows.
+        */
+        void set_worker_count(size_t worker_count_) {
+            std::lock_guard<std::mutex> lock(_messages_lock);
+            _worker_count = std::max(worker_count_, std::max<size_t>(_workers.size(), 1));
+            if (_workers.empty()) return;
+            while (_workers.size() < _worker_count)
+                _workers.emplace_back(&intercept::threaded_dispatcher::monitor, this);
+        }
+
+        size_t worker_count() {
+            std::lock_guard<std::mutex> lock(_messages_lock);
+            return _worker_count;
+        }
         
         bool call(const std::string_view name_, arguments & args_, std::string & result_, bool threaded) {
-            if (_methods.find(name_) == _methods.end()) {
+            auto method = _methods.find(name_);
+            if (!method) {
                 // @TODO: Exceptions
                 return false;
             }
             if (threaded) {
-                if (!_thread_running) start_thread();
-                std::lock_guard<std::mutex> lock(_messages_lock);
-                _messages.push(dispatch_message(name_, args_, _message_id));
-                
-                // @TODO: We should provide an interface for this serialization.
-                std::stringstream ss;
-                ss << "[\"result_id\", " << _message_id << "]";
-                result_ = ss.str();
+                uint64_t id;
+                {
+                    std::lock_guard<std::mutex> lock(_messages_lock);
+                    if (_workers.empty()) start_workers();
+                    id = _message_id++;
+                    _messages.push(dispatch_message(name_, args_, id));
+                }
+                _messages_condition.notify_one();
 
-                _message_id = _message_id + 1;
+                // @TODO: We should provide an interface for this serialization.
+                result_.assign("[\"result_id\", ").append(std::to_string(id)).append("]");
             } else {
 #ifdef _DEBUG
                 if (name_ != "fetch_result" && name_ != "do_invoke_period") {
                     TRACE("dispatch[immediate]:\t[{}] { {} }", name_, args_.get());
                 }
 #endif
-                return dispatcher::call(name_, args_, result_);
+                return (*method)(args_, result_);
             }
 
             return true;
@@ -112,11 +201,8 @@ namespace intercept {
             return call(name_, args_, result_, false);
         }
 
-        void push_result(const dispatch_result & result) {
-            {
-                std::lock_guard<std::mutex> lock(_results_lock);
-                _results.push(result);
-            }
+        void push_result(dispatch_result result) {
+            _results.push(std::move(result));
         }
         void push_result(const std::string & result) {
             push_result(dispatch_result(result, -1));
@@ -125,8 +211,11 @@ namespace intercept {
             for (auto module : _modules) {
                 module->stop();
             }
-            std::lock_guard<std::mutex> lock(_messages_lock);
-            _stop = true;
+            {
+                std::lock_guard<std::mutex> lock(_messages_lock);
+                _stop = true;
+            }
+            _messages_condition.notify_all();
         }
 
         void add_module(std::shared_ptr<controller_module> module_) {
@@ -134,64 +223,59 @@ namespace intercept {
         }
 
     protected:
-        void start_thread() {
-            _worker = std::thread(&intercept::threaded_dispatcher::monitor, this);
-            _thread_running = true;
+        //Called with _messages_lock held
+        void start_workers() {
+            _ready = false;
+            for (size_t i = 0; i < _worker_count; ++i)
+                _workers.emplace_back(&intercept::threaded_dispatcher::monitor, this);
         }
+
+        void join_workers() {
+            for (auto& worker : _workers) {
+                if (worker.joinable()) worker.join();
+            }
+        }
+
+        ///Wakes the workers after _ready was set, they don't take messages while it is false
+        void notify_ready() {
+            { std::lock_guard<std::mutex> lock(_messages_lock); }
+            _messages_condition.notify_all();
+        }
+
         void monitor() {
-            _ready = false;
-            while (!_stop) {//#TODO rewrite to use condition variable
-                
-                bool empty = false;
-                {
-                    std::lock_guard<std::mutex> lock(_messages_lock);
-                    empty = _messages.empty();
-                }
-                while (!empty) {
-                    if (_ready) {
-                        _messages_lock.lock();
-                        dispatch_result result;
-                        dispatch_message _message = std::move(_messages.front());
-                        _messages.pop();
-                        _messages_lock.unlock();
-
-                        result.id = _message.id;
-                        result.message.resize(4096);
+            std::unique_lock<std::mutex> lock(_messages_lock);
+            for (;;) {
+                _messages_condition.wait(lock, [this] { return _stop || (_ready && !_messages.empty()); });
+                if (_stop) return;
+                auto message = std::move(_messages.front());
+                _messages.pop();
+                lock.unlock();
+
 #ifdef _DEBUG
-                        if (_message.command != "fetch_result") {
-                            TRACE("dispatch[threaded]:\t[{}]", _message.command);
-                            if (_message.args.size() > 0) {
-                                //    LOG(TRACE) << "\t{ " << _messages.front().args.get() << " }";
-                            }
-                        }
-#endif
-                        dispatcher::call(_message.command, _message.args, result.message);
-                        {
-                            std::lock_guard<std::mutex> lock(_results_lock);
-                            _results.push(result);
-                        }
-                        {
-                            std::lock_guard<std::mutex> lock(_messages_lock);
-                            empty = _messages.empty();
-                        }
-                            
-                    }
+                if (message.command != "fetch_result") {
+                    TRACE("dispatch[threaded]:\t[{}]", message.command);
                 }
-                std::this_thread::sleep_for(5ms);
+#endif
+                dispatch_result result;
+                result.id = message.id;
+                arguments args(message.args);
+                dispatcher::call(message.command, args, result.message);
+                _results.push(std::move(result));
+
+                lock.lock();
             }
         }
         std::atomic_bool                _stop;
-        std::queue<dispatch_result>     _results;
-        std::mutex                      _results_lock;
+        mpsc_queue<dispatch_result>     _results;
 
         std::queue<dispatch_message>    _messages;
         std::mutex                      _messages_lock;
+        std::condition_variable         _messages_condition;
 
-        std::thread                     _worker;
+        std::vector<std::thread>        _workers;
 
         uint64_t                        _message_id;
-
-        bool                            _thread_running{false};
+        size_t                          _worker_count;
 
         std::vector<std::shared_ptr<controller_module>> _modules;
     };
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace intercept {
+    /*!
+    @brief A fixed size log-linear histogram in the style of HdrHistogram.
+
+    Values below 32 are counted exactly, above that every power of two range is
+    split into 16 linear sub buckets, which keeps the relative error of reported
+    percentiles below ~6% over the whole 32bit range.
+
+    Recording is lock free and can be done from any thread. Reads are not
+    synchronized with writes, which is good enough for telemetry.
+    */
+    class histogram {
+    public:
+        histogram() noexcept { reset(); }
+        histogram(const histogram &) = delete;
+        histogram & operator=(const histogram &) = delete;
+
+        void record(uint32_t value_) noexcept {
+            _buckets[bucket_index(value_)].fetch_add(1, std::memory_order_relaxed);
+            _count.fetch_add(1, std::memory_order_relaxed);
+            auto max = _max.load(std::memory_order_relaxed);
+            while (value_ > max && !_max.compare_exchange_weak(max, value_, std::memory_order_relaxed)) {}
+        }
+
+        uint64_t count() const noexcept { return _count.load(std::memory_order_relaxed); }
+        uint32_t max() const noexcept { return _max.load(std::memory_order_relaxed); }
+
+        /*!
+        @brief Returns the highest value that is equivalent to the given percentile.
+
+        @param percentile_ In the range of 0 to 100.
+        */
+        uint32_t percentile(double percentile_) const noexcept {
+            const auto total = count();
+            if (total == 0) return 0;
+            auto target = static_cast<uint64_t>(percentile_ / 100.0 * static_cast<double>(total) + 0.5);
+            if (target < 1) target = 1;
+
+            uint64_t seen = 0;
+            for (uint32_t i = 0; i < bucket_count; ++i) {
+                seen += _buckets[i].load(std::memory_order_relaxed);
+                if (seen >= target) {
+                    const auto highest = bucket_highest_value(i);
+                    return highest < max() ? highest : max();
+                }
+            }
+            return max();
+        }
+
+        void reset() noexcept {
+            for (auto &bucket : _buckets)
+                bucket.store(0, std::memory_order_relaxed);
+            _count.store(0, std::memory_order_relaxed);
+            _max.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr uint32_t sub_bucket_bits = 5;
+        static constexpr uint32_t sub_bucket_count = 1u << sub_bucket_bits;
+        static constexpr uint32_t sub_bucket_half = sub_bucket_count / 2;
+        static constexpr uint32_t bucket_count = sub_bucket_count + (32 - sub_bucket_bits) * sub_bucket_half;
+
+        static uint32_t highest_bit(uint32_t value_) noexcept {
+            uint32_t bit = 0;
+            while (value_ >>= 1) ++bit;
+            return bit;
+        }
+
+        static uint32_t bucket_index(uint32_t value_) noexcept {
+            if (value_ < sub_bucket_count) return value_;
+            const uint32_t shift = highest_bit(value_) - sub_bucket_bits + 1;
+            return sub_bucket_count + (shift - 1) * sub_bucket_half + ((value_ >> shift) - sub_bucket_half);
+        }
+
+        static uint32_t bucket_highest_value(uint32_t index_) noexcept {
+            if (index_ < sub_bucket_count) return index_;
+            const uint32_t shift = (index_ - sub_bucket_count) / sub_bucket_half + 1;
+            const uint64_t sub = (index_ - sub_bucket_count) % sub_bucket_half + sub_bucket_half;
+            return static_cast<uint32_t>(((sub + 1) << shift) - 1);
+        }
+
+        std::array<std::atomic<uint32_t>, bucket_count> _buckets;
+        std::atomic<uint64_t> _count;
+        std::atomic<uint32_t> _max;
+    };
+}
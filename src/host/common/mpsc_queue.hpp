@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace intercept {
+    /*!
+    @brief Multi producer, single consumer queue on a fixed size ring.
+
+    Pushing and popping are lock free as long as the ring has room. If the
+    consumer falls behind and the ring fills up, producers append to a mutex
+    protected overflow list instead of blocking. The consumer empties that after
+    the ring. Items of a single producer are popped in the order they were
+    pushed.
+
+    Only one thread may pop at a time.
+    */
+    template <typename Type>
+    class mpsc_queue {
+    public:
+        /*!
+        @param capacity_ Size of the ring, rounded up to a power of two.
+        */
+        explicit mpsc_queue(size_t capacity_ = 1024) {
+            size_t capacity = 2;
+            while (capacity < capacity_) capacity *= 2;
+            _mask = capacity - 1;
+            _cells = std::make_unique<cell[]>(capacity);
+            for (size_t i = 0; i < capacity; ++i)
+                _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mpsc_queue(const mpsc_queue &) = delete;
+        mpsc_queue &operator=(const mpsc_queue &) = delete;
+
+        void push(Type value_) {
+            //Once something overflowed, keep going there until the consumer caught up, so order is kept
+            if (!_overflowing.load(std::memory_order_acquire) && try_push_ring(value_)) return;
+            std::lock_guard<std::mutex> lock(_overflow_lock);
+            _overflow.push_back(std::move(value_));
+            _overflowing.store(true, std::memory_order_release);
+        }
+
+        /*!
+        @brief Pops the next item, consumer thread only.
+
+        @return false if the queue was empty.
+        */
+        bool try_pop(Type &value_) {
+            if (try_pop_ring(value_)) return true;
+            if (!_overflowing.load(std::memory_order_acquire)) return false;
+
+            std::lock_guard<std::mutex> lock(_overflow_lock);
+            //Producers might have finished a ring push right before they switched over
+            if (try_pop_ring(value_)) return true;
+            if (_overflow.empty()) {
+                _overflowing.store(false, std::memory_order_release);
+                return false;
+            }
+            value_ = std::move(_overflow.front());
+            _overflow.pop_front();
+            if (_overflow.empty()) _overflowing.store(false, std::memory_order_release);
+            return true;
+        }
+
+        ///Consumer thread only
+        void clear() {
+            Type discarded;
+            while (try_pop(discarded)) {}
+        }
+
+    private:
+        struct cell {
+            std::atomic<size_t> sequence;
+            Type value;
+        };
+
+        bool try_push_ring(Type &value_) {
+            auto position = _enqueue_position.load(std::memory_order_relaxed);
+            for (;;) {
+                auto &current = _cells[position & _mask];
+                const auto sequence = current.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if (difference == 0) {
+                    if (_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        current.value = std::move(value_);
+                        current.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (difference < 0) {
+                    return false;  //Full
+                } else {
+                    position = _enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool try_pop_ring(Type &value_) {
+            auto &current = _cells[_dequeue_position & _mask];
+            if (current.sequence.load(std::memory_order_acquire) != _dequeue_position + 1) return false;
+            value_ = std::move(current.value);
+            current.sequence.store(_dequeue_position + _mask + 1, std::memory_order_release);
+            ++_dequeue_position;
+            return true;
+        }
+
+        std::unique_ptr<cell[]> _cells;
+        size_t _mask;
+        alignas(64) std::atomic<size_t> _enqueue_position{0};
+        alignas(64) size_t _dequeue_position{0};
+
+        std::atomic_bool _overflowing{false};
+        std::mutex _overflow_lock;
+        std::deque<Type> _overflow;
+    };
+}  // namespace intercept
@@ -22,6 +22,7 @@ namespace intercept {
         add("export_ptr_list"sv, std::bind(&controller::export_ptr_list, this, std::placeholders::_1, std::placeholders::_2));
         // action results
         add("fetch_result"sv, std::bind(&intercept::controller::fetch_result, this, std::placeholders::_1, std::placeholders::_2));
+        add("set_dispatch_workers"sv, std::bind(&intercept::controller::set_dispatch_workers, this, std::placeholders::_1, std::placeholders::_2));
     }
 
     bool controller::init(const arguments &, std::string & result_) {
@@ -35,6 +36,15 @@ namespace intercept {
         return true;
     }
 
+    bool controller::set_dispatch_workers(const arguments & args_, std::string & result_) {
+        if (args_.size() < 1) return false;
+        set_worker_count(args_.as_uint32(0));
+        const auto workers = worker_count();
+        LOG(INFO, "Dispatcher uses {} worker threads", workers);
+        result_ = std::to_string(workers);
+        return true;
+    }
+
     bool controller::get_ready(const arguments &, std::string & result_) const {
         result_ = "0";
 
@@ -48,32 +58,26 @@ namespace intercept {
         _ready = false;
 
 
-        { 
-            std::lock_guard<std::mutex> lock_results(_results_lock);
-
-            while (!_results.empty()) {
-                _results.pop();
-            }
-
+        _results.clear();
+        {
+            std::lock_guard<std::mutex> lock(_messages_lock);
             while (!_messages.empty()) {
                 _messages.pop();
             }
         }
 
         _ready = true;
+        notify_ready();
 
         return true;
     }
 
     bool controller::fetch_result(const arguments &, std::string & result_) {
-        result_ = "";
-        if (!_results.empty()) {
-            std::lock_guard<std::mutex> _lock(_results_lock);
-            dispatch_result res = _results.front();
-            std::stringstream ss;
-            ss << "[" << res.id << ",[" << res.message << "]]";
-            result_ = ss.str();
-            _results.pop();
+        //Polled every frame, an empty result reuses the buffer and doesn't allocate
+        result_.clear();
+        dispatch_result res;
+        if (_results.try_pop(res)) {
+            result_.append("[").append(std::to_string(res.id)).append(",[").append(res.message).append("]]");
         }
         return true;
     }
@@ -23,11 +23,19 @@ namespace intercept {
 
         bool fetch_result(const arguments &, std::string &);
 
+        /*!
+        @brief Controller function for intercept::threaded_dispatcher::set_worker_count.
+
+        Takes the number of workers that run threaded commands, so a long running
+        command doesn't hold up the others. Returns the resulting worker count.
+        */
+        bool set_dispatch_workers(const arguments & args_, std::string & result_);
+
         bool export_ptr_list(const arguments & _args, std::string & result) const;
 
         bool do_stop(const arguments &, std::string &) {
             stop();
-            _worker.join();
+            join_workers();
             return true;
         }
     
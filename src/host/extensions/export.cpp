@@ -18,6 +18,18 @@ namespace intercept {
             return invoker::invoke_raw_nolock(function_, left_arg_, right_arg_);
         }
 
+        void invoke_raw_nular_async(uint32_t module_id_, const nular_function function_, invoke_async_callback callback_, void *user_data_) {
+            invoker::get().invoke_async(module_id_, function_, callback_, user_data_);
+        }
+
+        void invoke_raw_unary_async(uint32_t module_id_, const unary_function function_, const game_value & right_arg_, invoke_async_callback callback_, void *user_data_) {
+            invoker::get().invoke_async(module_id_, function_, right_arg_, callback_, user_data_);
+        }
+
+        void invoke_raw_binary_async(uint32_t module_id_, const binary_function function_, const game_value & left_arg_, const game_value & right_arg_, invoke_async_callback callback_, void *user_data_) {
+            invoker::get().invoke_async(module_id_, function_, left_arg_, right_arg_, callback_, user_data_);
+        }
+
         void get_type_structure(std::string_view type_name_, uintptr_t &type_def_, uintptr_t &data_type_def_) {
             auto structure = invoker::get().type_structures[std::string(type_name_)];
             type_def_ = structure.first;
@@ -26,7 +38,7 @@ namespace intercept {
 
         nular_function get_nular_function(std::string_view function_name_) {
             nular_function function;
-            if (loader::get().get_function(std::string(function_name_), function)) {
+            if (loader::get().get_function(function_name_, function)) {
                 return function;
             }
             return nullptr;
@@ -34,7 +46,7 @@ namespace intercept {
 
         unary_function get_unary_function(std::string_view function_name_) {
             unary_function function;
-            if (loader::get().get_function(std::string(function_name_), function)) {
+            if (loader::get().get_function(function_name_, function)) {
                 return function;
             }
             return nullptr;
@@ -42,7 +54,7 @@ namespace intercept {
 
         unary_function get_unary_function_typed(std::string_view function_name_, std::string_view right_arg_type_) {
             unary_function function;
-            if (loader::get().get_function(std::string(function_name_), function, std::string(right_arg_type_))) {
+            if (loader::get().get_function(function_name_, function, right_arg_type_)) {
                 return function;
             }
             return nullptr;
@@ -50,7 +62,7 @@ namespace intercept {
 
         binary_function get_binary_function(std::string_view function_name_) {
             binary_function function;
-            if (loader::get().get_function(std::string(function_name_), function)) {
+            if (loader::get().get_function(function_name_, function)) {
                 return function;
             }
             return nullptr;
@@ -58,7 +70,7 @@ namespace intercept {
 
         binary_function get_binary_function_typed(std::string_view function_name_, std::string_view left_arg_type_, std::string_view right_arg_type_) {
             binary_function function;
-            if (loader::get().get_function(std::string(function_name_), function, std::string(left_arg_type_), std::string(right_arg_type_))) {
+            if (loader::get().get_function(function_name_, function, left_arg_type_, right_arg_type_)) {
                 return function;
             }
             return nullptr;
@@ -72,6 +84,10 @@ namespace intercept {
             invoker::get().unlock();
         }
 
+        auto_array<invoker_metric> get_invoker_metrics(bool reset_) {
+            return invoker::get().get_metrics(reset_);
+        }
+
         const types::__internal::allocatorInfo* get_engine_allocator() {
             return loader::get().get_allocator();
         }
@@ -14,6 +14,7 @@ https://github.com/NouberNou/intercept
 #pragma once
 #include "shared.hpp"
 #include "shared/types.hpp"
+#include "shared/functions.hpp"
 
 using namespace intercept::types;
 
@@ -53,6 +54,16 @@ namespace intercept {
         */
         game_value invoke_raw_binary_nolock(const binary_function function_, const game_value &left_arg_, const game_value &right_arg_);
 
+        /*!@{
+        @brief Queues a raw SQF function call to be executed in the next invoke period.
+
+        callback_ receives the raw returned data and user_data_ on the main thread.
+        */
+        void invoke_raw_nular_async(uint32_t module_id_, const nular_function function_, invoke_async_callback callback_, void *user_data_);
+        void invoke_raw_unary_async(uint32_t module_id_, const unary_function function_, const game_value &right_arg_, invoke_async_callback callback_, void *user_data_);
+        void invoke_raw_binary_async(uint32_t module_id_, const binary_function function_, const game_value &left_arg_, const game_value &right_arg_, invoke_async_callback callback_, void *user_data_);
+        //!@}
+
         /*!
         @brief Returns type definitions for a given type string.
         
@@ -80,6 +91,13 @@ namespace intercept {
 
         void invoker_unlock();
 
+        /*!
+        @brief Returns the invoker telemetry histograms.
+
+        @param reset_ Clears the histograms after reading them.
+        */
+        auto_array<invoker_metric> get_invoker_metrics(bool reset_);
+
         /*!
         @brief Get's a pointer to Arma's memory allocator
 
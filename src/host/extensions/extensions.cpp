@@ -2,9 +2,15 @@
 #include "controller.hpp"
 #include "export.hpp"
 #include "invoker.hpp"
+#include "sqf_functions.hpp"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
 #ifdef __linux__
 #include <dlfcn.h>
 #include <link.h>
+#include <unistd.h>
 #endif
 
 #define PLUGIN_MIN_API_VERSION 2
@@ -44,6 +50,14 @@ namespace intercept {
         };
         functions.get_pbo_files_list = client_function_defs::get_pbo_files_list;
 
+        functions_v3.invoke_raw_nular_async = client_function_defs::invoke_raw_nular_async;
+        functions_v3.invoke_raw_unary_async = client_function_defs::invoke_raw_unary_async;
+        functions_v3.invoke_raw_binary_async = client_function_defs::invoke_raw_binary_async;
+        functions_v3.get_invoker_metrics = client_function_defs::get_invoker_metrics;
+        functions_v3.get_module_id = [](std::string_view module_name_) {
+            return extensions::get().module_id(module_name_);
+        };
+
         std::string arg_line = search::plugin_searcher::get_command_line();
         std::transform(arg_line.begin(), arg_line.end(), arg_line.begin(), ::tolower);
         if (arg_line.find("-intreloadall"sv) != std::string::npos) {
@@ -54,6 +68,10 @@ namespace intercept {
             ignore_cert_fail = true;
         }
 
+        if (arg_line.find("-inthotreload"sv) != std::string::npos) {
+            hot_reload = true;
+        }
+
     }
 
     extensions::~extensions() {
@@ -66,8 +84,10 @@ namespace intercept {
 
     void extensions::attach_controller() {
         controller::get().add("list_extensions"sv, std::bind(&extensions::list, this, std::placeholders::_1, std::placeholders::_2));
-        controller::get().add("load_extension"sv, [this](const arguments& args_, std::string&) { return load(args_.as_string(0), args_.size() > 1 ? args_.as_string(1) : ""); });
-        controller::get().add("unload_extension"sv, [this](const arguments& args_, std::string&) { return unload(args_.as_string(0)); });
+        controller::get().add("load_extensions"sv, std::bind(&extensions::load_all, this, std::placeholders::_1, std::placeholders::_2));
+        controller::get().add("load_extension"sv, [this](const arguments& args_, std::string&) { return load(std::string(args_.as_string(0)), args_.size() > 1 ? std::string(args_.as_string(1)) : ""); });
+        controller::get().add("reload_extension"sv, [this](const arguments& args_, std::string&) { return reload(std::string(args_.as_string(0))); });
+        controller::get().add("unload_extension"sv, [this](const arguments& args_, std::string&) { return unload(std::string(args_.as_string(0))); });
     }
 
     void extensions::reload_all() {
@@ -81,7 +101,133 @@ namespace intercept {
         }
     }
 
+    bool extensions::reload(const std::string& path_) {
+        auto module = _modules.find(path_);
+        if (module == _modules.end()) {
+            LOG(ERROR, "Reload failed, module not loaded [{}]", path_);
+            return false;
+        }
+        LOG(INFO, "Reload requested [{}]", path_);
+        const auto certificate_path = module->second.certificate_path;
+
+        //Unloading forgets who used this module's interfaces, remember them to hand the reloaded ones back
+        std::vector<std::pair<module::plugin_interface_identifier, std::vector<r_string>>> interface_users;
+        for (auto& iface : module->second.exported_interfaces) {
+            auto found = exported_interfaces.find(iface);
+            if (found != exported_interfaces.end() && !found->second.modules_using_interface.empty())
+                interface_users.emplace_back(iface, found->second.modules_using_interface);
+        }
+
+        //Lets the module's SQF functions unregister when it unloads and register again in pre_start
+        const bool could_register = sqf_functions::get().isEnabled();
+        sqf_functions::get().setEnabled();
+        unload(path_);
+        load(path_, certificate_path);
+        auto reloaded = _modules.find(path_);
+        if (reloaded != _modules.end()) {
+            if (reloaded->second.functions.pre_start) reloaded->second.functions.pre_start();
+            if (reloaded->second.functions.post_start) reloaded->second.functions.post_start();
+        }
+        if (!could_register) sqf_functions::get().setDisabled();
+
+        //The new binary registered its interfaces in load, interfaces it dropped stay unloaded for their users
+        for (auto& [ident, users] : interface_users) {
+            auto iface = exported_interfaces.find(ident);
+            if (iface == exported_interfaces.end()) continue;
+            iface->second.modules_using_interface = users;
+            for (auto& plugin : _modules) {
+                if (!plugin.second.functions.on_interface_reload) continue;
+                if (std::find(users.begin(), users.end(), plugin.second.name) != users.end())
+                    plugin.second.functions.on_interface_reload(ident.name);
+            }
+        }
+
+        return reloaded != _modules.end();
+    }
+
+    void extensions::reload_changed() {
+        if (!hot_reload) return;
+        for (auto& file : _watcher.poll()) {
+            auto module = std::find_if(_modules.begin(), _modules.end(), [&file](auto& module_) { return module_.second.path == file; });
+            if (module == _modules.end()) continue;
+            const auto path = module->first; //reload erases the entry
+            reload(path);
+        }
+    }
+
     bool extensions::load(const std::string& path_, std::optional<std::string> certPath) {
+        LOG(INFO, "Load requested [{}]", path_);
+
+        if (_modules.find(path_) != _modules.end()) {
+            LOG(ERROR, "Module already loaded [{}]", path_) ;
+            return true;
+        }
+
+        auto plugin = prepare_load(path_, read_certificate(certPath));
+        _signTool.save_cache();
+        plugin.certificate_path = std::move(certPath);
+        return commit_load(plugin);
+    }
+
+    bool extensions::load_all(const arguments& args_, std::string&) {
+        std::vector<std::pair<std::string, std::optional<r_string>>> requests;
+        std::vector<std::optional<std::string>> certificate_paths;
+        for (uint32_t i = 0; i < args_.size(); i += 2) {
+            std::string path(args_.as_string(i));
+            if (path.empty()) continue;
+            LOG(INFO, "Load requested [{}]", path);
+
+            const bool requested_twice = std::find_if(requests.begin(), requests.end(), [&path](auto& request_) { return request_.first == path; }) != requests.end();
+            if (requested_twice || _modules.find(path) != _modules.end()) {
+                LOG(ERROR, "Module already loaded [{}]", path);
+                continue;
+            }
+            std::optional<std::string> cert_path;
+            if (i + 1 < args_.size()) cert_path = std::string(args_.as_string(i + 1));
+            //loadfile has to run on the game thread, so the certificates are read before the workers start
+            requests.emplace_back(std::move(path), read_certificate(cert_path));
+            certificate_paths.emplace_back(std::move(cert_path));
+        }
+
+        //Searching and verifying is independent per plugin, the loading itself stays on this thread and in order
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<prepared_plugin> plugins(requests.size());
+        std::atomic<size_t> next_request{0};
+        auto prepare_requests = [&]() {
+            for (size_t i = next_request++; i < requests.size(); i = next_request++)
+                plugins[i] = prepare_load(requests[i].first, requests[i].second);
+        };
+        const size_t thread_count = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), requests.size());
+        std::vector<std::thread> workers;
+        _searcher.begin_batch();
+        for (size_t i = 1; i < thread_count; ++i)
+            workers.emplace_back(prepare_requests);
+        prepare_requests();
+        for (auto& worker : workers)
+            worker.join();
+        _searcher.end_batch();
+        _signTool.save_cache();
+        LOG(INFO, "Prepared {} plugins on {} threads in {}ms", plugins.size(), thread_count,
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+
+        for (size_t i = 0; i < plugins.size(); ++i) {
+            plugins[i].certificate_path = std::move(certificate_paths[i]);
+            commit_load(plugins[i]);
+        }
+        return true;
+    }
+
+    std::optional<r_string> extensions::read_certificate([[maybe_unused]] const std::optional<std::string>& cert_path_) {
+    #ifndef __linux__
+        if (cert_path_ && cert_path_->length() != 0)
+            return static_cast<r_string>(invoker::get().invoke_raw("loadfile", *cert_path_));
+    #endif
+        return {};
+    }
+
+    extensions::prepared_plugin extensions::prepare_load(const std::string& path_, [[maybe_unused]] const std::optional<r_string>& certificate_) {
+        prepared_plugin plugin;
+        plugin.path = path_;
 
     #ifndef __linux__
         using string_type = std::wstring;
@@ -98,69 +244,63 @@ namespace intercept {
         string_view_type bad_chars = ".\\/:?\"<>|"sv;
     #endif
 
-        LOG(INFO, "Load requested [{}]", path_);
-
-        if (_modules.find(path_) != _modules.end()) {
-            LOG(ERROR, "Module already loaded [{}]", path_) ;
-            return true;
-        }
-
         //Filter out bad chars
         for (auto it = path.begin(); it < path.end(); ++it) {
             const bool found = bad_chars.find(*it) != std::string::npos;
             if (found) {
                 LOG(ERROR, "Client plugin: {} contains illegal characters in its name.", path_);
-                return false;
+                return plugin;
             }
         }
 
         auto full_path = _searcher.find_extension(path);
         if (!full_path) {
-            invoker::get().invoke_raw("diag_log", fmt::format("Intercept: Client plugin: {} was not found.", path_));
+            plugin.diag_message = fmt::format("Intercept: Client plugin: {} was not found.", path_);
             LOG(ERROR, "Client plugin: {} was not found.", path_);
-            return false;
+            return plugin;
         }
-            
+        plugin.full_path = std::move(*full_path);
 
-        cert::signing::security_class security_class = cert::signing::security_class::core;
     #ifndef __linux__
-        if (certPath && certPath->length() != 0) { //certificate check
-            r_string certData = invoker::get().invoke_raw("loadfile", *certPath);
-            auto res = _signTool.verifyCert(*full_path, certData);
-            security_class = res.first;
-            if (security_class == cert::signing::security_class::not_signed && !ignore_cert_fail) {  //certpath was set so a certificate was certainly wanted
+        if (certificate_) { //certificate check
+            auto res = _signTool.verifyCert_cached(plugin.full_path, *certificate_);
+            plugin.security_class = res.first;
+            if (plugin.security_class == cert::signing::security_class::not_signed && !ignore_cert_fail) {  //certpath was set so a certificate was certainly wanted
                 if (res.second) {
-                    invoker::get().invoke_raw("diag_log", fmt::format("Signature check failed on {} because {}", path_, *res.second));
+                    plugin.diag_message = fmt::format("Signature check failed on {} because {}", path_, *res.second);
                     LOG(ERROR, "PluginLoad failed, code signing certificate invalid [{}] because {}", path_, *res.second);
                 } else {
-                    invoker::get().invoke_raw("diag_log", fmt::format("Signature check failed on {} because {}", path_));
+                    plugin.diag_message = fmt::format("Signature check failed on {}", path_);
                     LOG(ERROR, "PluginLoad failed, code signing certificate invalid [{}]", path_);
                 }
-                invoker::get().invoke_raw("diag_log", fmt::format("Signature check failed on {}", path_));
-                LOG(ERROR, "PluginLoad failed, code signing certificate invalid [{}]", path_);
-                return false;
+                return plugin;
             }
         }
     #ifdef _DEBUG 
-        if (ignore_cert_fail && security_class != cert::signing::security_class::core) {
-            security_class = cert::signing::security_class::core;
+        if (ignore_cert_fail && plugin.security_class != cert::signing::security_class::core) {
+            plugin.security_class = cert::signing::security_class::core;
             LOG(WARNING, "Ignoring Certificate and granting core-level access [{}]", path_);
         }
     #endif
-
-
     #endif
 
+        plugin.ok = true;
+        return plugin;
+    }
 
-
-
-
-
-
-
+    bool extensions::commit_load(prepared_plugin& plugin_) {
+        const auto& path_ = plugin_.path;
+        if (!plugin_.ok) {
+            if (plugin_.diag_message)
+                invoker::get().invoke_raw("diag_log", *plugin_.diag_message);
+            return false;
+        }
+        auto full_path = plugin_.full_path;
+        [[maybe_unused]] const auto security_class = plugin_.security_class;
 
 #ifndef __linux__  //Lazyness
-        if (do_reload) {
+        //Loading a copy leaves the original free to be overwritten by the next build
+        if (do_reload || hot_reload) {
             LOG(INFO, "Loading plugin from temp file.");
             wchar_t tmpPath[MAX_PATH + 1], buffer[MAX_PATH + 1];
 
@@ -174,26 +314,42 @@ namespace intercept {
             }
             std::wstring temp_filename = buffer;
             //LOG(INFO, "Temp file: {}", temp_filename);
-            if (!CopyFileW(full_path->c_str(), temp_filename.c_str(), FALSE)) {
+            if (!CopyFileW(full_path.c_str(), temp_filename.c_str(), FALSE)) {
                 DeleteFileW(temp_filename.c_str());
-                if (!CopyFileW(full_path->c_str(), temp_filename.c_str(), FALSE)) {
+                if (!CopyFileW(full_path.c_str(), temp_filename.c_str(), FALSE)) {
                     LOG(ERROR, "CopyFile() failed, e={}", GetLastError());
                     return false;
                 }
             }
             full_path = temp_filename;
         }
+#else
+        //dlopen hands back the still mapped old image if a library with the same path didn't fully unload
+        if (hot_reload) {
+            static uint32_t copy_count = 0;
+            std::error_code error;
+            const auto temp_path = std::filesystem::temp_directory_path(error) / fmt::format("intercept_temp_{}_{}_{}.so", getpid(), path_, copy_count++);
+            if (error || !std::filesystem::copy_file(full_path, temp_path, std::filesystem::copy_options::overwrite_existing, error)) {
+                LOG(ERROR, "Copying plugin to temp file failed, e={} [{}]", error.message(), path_);
+                return false;
+            }
+            full_path = temp_path.string();
+        }
 #endif
 
 #ifdef __linux__
-        auto dllHandle = dlopen(full_path->c_str(), RTLD_NOW | RTLD_GLOBAL);
+        auto dllHandle = dlopen(full_path.c_str(), RTLD_NOW | RTLD_GLOBAL);
+        if (full_path != plugin_.full_path) {
+            std::error_code error;
+            std::filesystem::remove(full_path, error); //Stays mapped until dlclose
+        }
         if (!dllHandle) {
             invoker::get().invoke_raw("diag_log", fmt::format("Intercept: LoadLibrary() failed, e={} [{}]", dlerror(), path_));
             LOG(ERROR, "LoadLibrary() failed, e={} [{}]", dlerror(), path_);
             return false;
         }
 #else
-        auto dllHandle = LoadLibraryW(full_path->c_str());
+        auto dllHandle = LoadLibraryW(full_path.c_str());
         if (!dllHandle) {
             invoker::get().invoke_raw("diag_log", fmt::format("Intercept: LoadLibrary() failed, e={} [{}]", GetLastError(), path_));
             LOG(ERROR, "LoadLibrary() failed, e={} [{}]", GetLastError(), path_);
@@ -201,13 +357,14 @@ namespace intercept {
         }
 #endif
 
+        //Named after the original binary rather than a temp copy, so a reloaded module keeps its name and id
     #ifndef __linux__
-        length = WideCharToMultiByte(CP_UTF8, 0, (*full_path).data(), (*full_path).length(), nullptr, 0, nullptr, nullptr);
+        auto length = WideCharToMultiByte(CP_UTF8, 0, plugin_.full_path.data(), plugin_.full_path.length(), nullptr, 0, nullptr, nullptr);
         std::string utf8_name;
         utf8_name.resize(length);
-        WideCharToMultiByte(CP_UTF8, 0, (*full_path).data(), (*full_path).length(), utf8_name.data(), length, nullptr, nullptr);
+        WideCharToMultiByte(CP_UTF8, 0, plugin_.full_path.data(), plugin_.full_path.length(), utf8_name.data(), length, nullptr, nullptr);
     #else
-        string_type utf8_name = *full_path;
+        std::string utf8_name = plugin_.full_path;
     #endif
 
         auto new_module = module::entry(utf8_name, dllHandle, security_class);
@@ -220,6 +377,7 @@ namespace intercept {
 
         new_module.functions.api_version = reinterpret_cast<module::api_version_func>(GET_PROC_ADDR(dllHandle, "api_version"));
         new_module.functions.assign_functions = reinterpret_cast<module::assign_functions_func>(GET_PROC_ADDR(dllHandle, "assign_functions"));
+        new_module.functions.assign_functions_v3 = reinterpret_cast<module::assign_functions_v3_func>(GET_PROC_ADDR(dllHandle, "assign_functions_v3"));
         new_module.functions.client_eventhandlers_clear = reinterpret_cast<module::client_eventhandlers_clear_func>(GET_PROC_ADDR(dllHandle, "client_eventhandlers_clear"));
         auto is_signed_function = reinterpret_cast<module::is_signed_function>(GET_PROC_ADDR(dllHandle, "is_signed"));
 
@@ -267,6 +425,8 @@ namespace intercept {
         new_module.functions.pre_start = reinterpret_cast<module::pre_start_func>(GET_PROC_ADDR(dllHandle, "pre_start"));
         new_module.functions.post_start = reinterpret_cast<module::pre_start_func>(GET_PROC_ADDR(dllHandle, "post_start"));
         new_module.functions.register_interfaces = reinterpret_cast<module::register_interfaces_func>(GET_PROC_ADDR(dllHandle, "register_interfaces"));
+        new_module.functions.on_interface_unload = reinterpret_cast<module::on_interface_unload_func>(GET_PROC_ADDR(dllHandle, "on_interface_unload"));
+        new_module.functions.on_interface_reload = reinterpret_cast<module::on_interface_reload_func>(GET_PROC_ADDR(dllHandle, "on_interface_reload"));
         new_module.functions.client_eventhandler = reinterpret_cast<module::client_eventhandler_func>(GET_PROC_ADDR(dllHandle, "client_eventhandler"));
 
 
@@ -276,12 +436,19 @@ namespace intercept {
         EH_LIST(EH_PROC_DEF)
 
 
+        new_module.id = module_id(new_module.name);
         new_module.functions.assign_functions(functions, r_string(new_module.name));
-        new_module.path = *full_path;
+        //Plugins built against an older client don't export it
+        if (new_module.functions.assign_functions_v3)
+            new_module.functions.assign_functions_v3(&functions_v3, r_string(new_module.name));
+        new_module.path = plugin_.full_path;
+        new_module.certificate_path = plugin_.certificate_path;
 
 
 
-        _modules[path_] = new_module;
+        auto& stored_module = _modules[path_] = new_module;
+        _modules_by_id[stored_module.id] = &stored_module;
+        rebuild_eventhandler_subscribers();
 #ifndef __linux__
         _module_security_classes[reinterpret_cast<uintptr_t>(dllHandle)] = security_class;
 #endif
@@ -289,6 +456,9 @@ namespace intercept {
         if (new_module.functions.register_interfaces)
             new_module.functions.register_interfaces();
 
+        if (hot_reload)
+            _watcher.add(new_module.path);
+
 
         invoker::get().invoke_raw("diag_log", fmt::format("Intercept: Load completed [{}]", path_));
         LOG(INFO, "Load completed [{}]", path_);
@@ -315,15 +485,30 @@ namespace intercept {
             auto& module_list = entry.second;
             for (auto& plugin : _modules) {
                 if (!plugin.second.functions.on_interface_unload) continue;
-                auto found = std::find(module_list.begin(), module_list.end(), plugin.first);
+                //Interface users are known by the module name that was passed to their assign_functions
+                auto found = std::find(module_list.begin(), module_list.end(), plugin.second.name);
                 if (found != module_list.end()) {
                     plugin.second.functions.on_interface_unload(iface_name);
                 }
             }
         }
 
+        //Forget the interfaces of this module, and that it used others. A reload registers and requests them again.
+        for (auto& iface : module->second.exported_interfaces)
+            exported_interfaces.erase(iface);
+        for (auto& iface : exported_interfaces) {
+            auto& users = iface.second.modules_using_interface;
+            users.erase(std::remove(users.begin(), users.end(), module->second.name), users.end());
+        }
+        if (hot_reload)
+            _watcher.remove(module->second.path);
+
+        //Queued async calls hand their result to a callback in the module. Threads of the module may still queue
+        //calls until handle_unload stopped them, so this is done again right before the module is freed.
+        invoker::get().complete_async_jobs(module->second.id);
         if (module->second.functions.handle_unload_internal) module->second.functions.handle_unload_internal();
         if (module->second.functions.handle_unload) module->second.functions.handle_unload();
+        invoker::get().complete_async_jobs(module->second.id);
 
 #ifdef __linux
         if (dlclose(module->second.handle)) {  //returms 0 on success
@@ -336,7 +521,9 @@ namespace intercept {
         }
         LOG(INFO, "Unload complete [{}]", path_);//path_ sometimes becomes corrupted if placed after the erase
 
+        _modules_by_id[module->second.id] = nullptr;
         _modules.erase(path_);
+        rebuild_eventhandler_subscribers();
 
         return true;
     }
@@ -372,6 +559,12 @@ namespace intercept {
 
         //No duplicates and module owns that interface so.. Insert it
         exported_interfaces.insert({ident, {ident, interface_class_}});
+        for (auto& module : _modules) {
+            if (module_name_ == module.second.name) {
+                module.second.exported_interfaces.push_back(ident);
+                break;
+            }
+        }
 
         return register_plugin_interface_result::success;
     }
@@ -395,7 +588,10 @@ namespace intercept {
                                       return item.first.api_version == api_version_ && item.first.name == name_;  //compare cheaper stuff first
                                   });
         if (iface != exported_interfaces.end()) {
-            iface->second.modules_using_interface.push_back(module_name_);
+            //Users request again after on_interface_reload, they are still in the list
+            auto& users = iface->second.modules_using_interface;
+            if (std::find(users.begin(), users.end(), module_name_) == users.end())
+                users.push_back(module_name_);
             return ((*iface).second.interface_class);
         }
         return {};
@@ -405,4 +601,20 @@ namespace intercept {
         return _modules;
     }
 
+    void extensions::rebuild_eventhandler_subscribers() {
+        module::eventhandler_subscribers subscribers;
+        for (auto& module : _modules) {
+#define EH_SUBSCRIBE(name, ...) if (module.second.eventhandlers.name) subscribers.name.push_back(module.second.eventhandlers.name);
+            EH_LIST(EH_SUBSCRIBE)
+#undef EH_SUBSCRIBE
+        }
+        _eventhandler_subscribers = std::move(subscribers);
+    }
+
+    uint32_t extensions::module_id(std::string_view name_) {
+        const auto inserted = _module_ids.emplace(name_, static_cast<uint32_t>(_module_ids.size()));
+        if (inserted.second) _modules_by_id.push_back(nullptr);
+        return inserted.first->second;
+    }
+
 }  // namespace intercept
@@ -20,6 +20,7 @@ https://github.com/NouberNou/intercept
 #include "singleton.hpp"
 #include "signing.hpp"
 #include "search.hpp"
+#include "watcher.hpp"
 
 #if __linux__
 #define DLL_HANDLE void *
@@ -29,6 +30,7 @@ https://github.com/NouberNou/intercept
 
 #define EXP_FNC_typedef(name, ...) typedef void(CDECL * name##_func)(__VA_ARGS__);
 #define EXP_FNC_STRUCT_DEF(name, ...) name##_func name;
+#define EXP_FNC_SUBSCRIBERS_DEF(name, ...) std::vector<name##_func> name;
 
 namespace intercept {
     /*!
@@ -45,6 +47,7 @@ namespace intercept {
         */
         typedef int(CDECL *api_version_func)();
         typedef void(CDECL *assign_functions_func)(const struct client_functions funcs, r_string module_name);
+        typedef void(CDECL *assign_functions_v3_func)(const struct client_functions_v3 *funcs, r_string module_name);
         typedef void(CDECL *handle_unload_func)();
         typedef void(CDECL *pre_start_func)();
         typedef void(CDECL *pre_init_func)();
@@ -53,6 +56,7 @@ namespace intercept {
         typedef void(CDECL *on_frame_func)();
         typedef void(CDECL *on_signal_func)(game_value_parameter this_);
         typedef void(CDECL *on_interface_unload_func)(r_string name_);
+        typedef void(CDECL *on_interface_reload_func)(r_string name_);
         typedef void(CDECL *register_interfaces_func)();
         typedef void(CDECL *client_eventhandler_func)(game_value& retVal, uint8_t ehType, int32_t uid, int handle, game_value args);
         typedef void(CDECL *client_eventhandlers_clear_func)();
@@ -69,6 +73,7 @@ namespace intercept {
             */
             api_version_func api_version;
             assign_functions_func assign_functions;
+            assign_functions_v3_func assign_functions_v3;
             handle_unload_func handle_unload;
             handle_unload_func handle_unload_internal;
             pre_start_func pre_start;
@@ -80,6 +85,7 @@ namespace intercept {
             on_frame_func on_frame;
             on_signal_func on_signal;
             on_interface_unload_func on_interface_unload;
+            on_interface_reload_func on_interface_reload;
             register_interfaces_func register_interfaces;
             client_eventhandler_func client_eventhandler;
             client_eventhandlers_clear_func client_eventhandlers_clear;
@@ -140,6 +146,13 @@ namespace intercept {
             EH_LIST(EXP_FNC_STRUCT_DEF)
         };
 
+        /*!
+        @brief Per event, the handlers of all loaded modules that export it.
+        */
+        struct eventhandler_subscribers {
+            EH_LIST(EXP_FNC_SUBSCRIBERS_DEF)
+        };
+
         /*!
         @brief This contains all information to identify a specific version of a specific plugin interface.
         */
@@ -187,7 +200,7 @@ namespace intercept {
             std::string name;
 
             /*!
-            @brief The path of the loaded module
+            @brief The path of the plugin binary. It may be loaded from a temporary copy of it.
             */
         #ifdef __linux
             std::string
@@ -227,6 +240,16 @@ namespace intercept {
             
             /// @todo doc
             cert::signing::security_class security_class;
+
+            /// @brief The certificate the module was loaded with, so a reload checks against the same one.
+            std::optional<std::string> certificate_path;
+
+            /*!
+            @brief Small number identifying the module in InterceptClientEvent calls.
+
+            Stays the same when the module is unloaded and loaded again.
+            */
+            uint32_t id{0};
         };
     }  // namespace module
 
@@ -256,8 +279,33 @@ namespace intercept {
         */
         bool load(const std::string &path_, std::optional<std::string> certPath);
 
+        /*!
+        @brief Loads several client plugins, takes name,certificate pairs.
+
+        Searching the plugins and checking their signatures runs on a thread per
+        core, the plugins are then loaded on the calling thread in the order they
+        were passed in.
+        */
+        bool load_all(const arguments &args_, std::string &result);
+
         void reload_all();
 
+        /*!
+        @brief Unloads a single plugin and loads it again from the same binary.
+
+        The other modules stay as they are. Only users of the interfaces this
+        module exports get on_interface_unload. Its SQF functions are unregistered
+        when it unloads and its pre_start and post_start run again to register
+        them anew. Users of an interface that the new binary registers again stay
+        its users and get on_interface_reload, to request the new interface class.
+        */
+        bool reload(const std::string &path_);
+
+        /*!
+        @brief With -intHotReload, reloads the plugins whose binaries changed. Called once per frame.
+        */
+        void reload_changed();
+
         /*!
         @brief Unloads a client plugin.
 
@@ -292,10 +340,30 @@ namespace intercept {
         */
         std::unordered_map<std::string, module::entry> &modules();
 
+        /*!
+        @brief Returns the handlers subscribed to each event, rebuilt whenever a module loads or unloads.
+        */
+        const module::eventhandler_subscribers &eventhandler_subscribers() const noexcept {
+            return _eventhandler_subscribers;
+        }
+
+        /*!
+        @brief Returns the id of the module with that name, assigning the next free one on first use.
+        */
+        uint32_t module_id(std::string_view name_);
+
+        /*!
+        @brief Returns the loaded module with that id, or nullptr if it isn't loaded.
+        */
+        module::entry *module_by_id(uint32_t id_) const noexcept {
+            return id_ < _modules_by_id.size() ? _modules_by_id[id_] : nullptr;
+        }
+
         /*!
         @brief The struct that contains the functions exported to client plugins.
         */
         client_functions functions;
+        client_functions_v3 functions_v3;
 
         /*!
         @brief A list of exported Plugin Interfaces.
@@ -307,6 +375,8 @@ namespace intercept {
 
         bool ignore_cert_fail = false;
 
+        bool hot_reload = false;
+
         cert::signing::security_class get_module_security_class(uintptr_t mod_base) {
             auto found = _module_security_classes.find(mod_base);
             if (found != _module_security_classes.end())
@@ -321,10 +391,47 @@ namespace intercept {
         */
         std::unordered_map<std::string, module::entry> _modules;
 
+        /*!
+        @brief Loaded modules indexed by their id, unloaded ones are nullptr.
+        @note Points into _modules, which doesn't move its values on insert.
+        */
+        std::vector<module::entry *> _modules_by_id;
+
+        /// @brief Ids handed out so far, by module name. Kept across unloads so a reloaded module keeps its id.
+        std::unordered_map<std::string, uint32_t> _module_ids;
+
+        module::eventhandler_subscribers _eventhandler_subscribers;
+
+        /// @brief Collects the exported event handlers of all loaded modules into _eventhandler_subscribers.
+        void rebuild_eventhandler_subscribers();
+
         /// @brief a map of module base adresses to their security class
         std::map<uintptr_t, cert::signing::security_class> _module_security_classes;
 
+        /// @brief The part of loading a plugin that doesn't need the game thread
+        struct prepared_plugin {
+            std::string path;
+        #ifdef __linux__
+            std::string full_path;
+        #else
+            std::wstring full_path;
+        #endif
+            cert::signing::security_class security_class = cert::signing::security_class::core;
+            std::optional<std::string> certificate_path;
+            bool ok = false;
+            /// @brief Logged with diag_log when the plugin is committed, which has to happen on the game thread.
+            std::optional<std::string> diag_message;
+        };
+
+        /// @brief Reads the certificate through loadfile, must be called on the game thread.
+        std::optional<r_string> read_certificate(const std::optional<std::string> &cert_path_);
+        /// @brief Finds the plugin and verifies its signature. Safe to call from several threads at once.
+        prepared_plugin prepare_load(const std::string &path_, const std::optional<r_string> &certificate_);
+        /// @brief Loads a prepared plugin and stores it in the list of loaded modules.
+        bool commit_load(prepared_plugin &plugin_);
+
         search::plugin_searcher _searcher;
+        search::plugin_watcher _watcher;
         cert::signing _signTool;
     };
 
@@ -5,15 +5,42 @@
 #include <regex>
 #include <filesystem>
 #include <string_view>
+#include <chrono>
+#include <cwctype>
+#include <fstream>
 
 using namespace std::literals::string_view_literals;
 
 namespace intercept::search {
-    plugin_searcher::plugin_searcher() {
-        auto pboList = generate_pbo_list();
-        //std::cout << "pbolist " << pboList.size() << "\n";
-        for (auto& file : pboList) {
-            //std::cout << "mod " << file << "\n";
+    namespace {
+    #ifdef __linux__
+        const std::string_view plugin_suffix = ".so"sv;
+    #elif _WIN64 || __X86_64__
+        const std::wstring_view plugin_suffix = L"_x64.dll"sv;
+    #else
+        const std::wstring_view plugin_suffix = L".dll"sv;
+    #endif
+
+        //Windows paths are case insensitive, so are the index keys there
+        plugin_searcher::string_type index_key(plugin_searcher::string_type name_) {
+        #ifndef __linux__
+            std::transform(name_.begin(), name_.end(), name_.begin(), ::towlower);
+        #endif
+            return name_;
+        }
+
+        int64_t elapsed_us(std::chrono::steady_clock::time_point start_) {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_).count();
+        }
+    }  // namespace
+
+    //The index is built on the first lookup, this runs before logging is set up
+    plugin_searcher::plugin_searcher() {}
+
+    std::vector<plugin_searcher::string_type> plugin_searcher::mod_folders(const std::vector<string_type>& pbo_list_) {
+        std::vector<string_type> folders;
+        for (auto& file : pbo_list_) {
+            //<mod>/addons/<name>.pbo -> <mod>
             size_t last_index = file.find_last_of(
             #ifdef __linux__
                 "\\/"
@@ -21,13 +48,7 @@ namespace intercept::search {
                 L"\\/"
             #endif
             );
-        #ifdef __linux__
-            std::string
-        #else
-            std::wstring
-        #endif
-            path = file.substr(0, last_index);
-            //std::cout << "path " << path << "\n";
+            string_type path = file.substr(0, last_index);
             last_index = path.find_last_of(
             #ifdef __linux__
                 "\\/"
@@ -36,10 +57,49 @@ namespace intercept::search {
             #endif
             );
             path = path.substr(0, last_index);
-            //std::cout << "modfolder " << path << "\n";
-            if (std::find(active_mod_folder_list.begin(), active_mod_folder_list.end(), path) == active_mod_folder_list.end())
-                active_mod_folder_list.emplace_back(std::move(path));
+            if (std::find(folders.begin(), folders.end(), path) == folders.end())
+                folders.emplace_back(std::move(path));
+        }
+        return folders;
+    }
+
+    void plugin_searcher::build_index() {
+        const auto start = std::chrono::steady_clock::now();
+        _plugin_index.clear();
+        _indexed = true;
+        for (auto& folder : active_mod_folder_list) {
+            std::error_code error;
+            const auto plugin_folder = std::filesystem::path(folder) / "intercept";
+            for (std::filesystem::directory_iterator file(plugin_folder, error), end; !error && file != end; file.increment(error)) {
+                if (!file->is_regular_file(error)) continue;
+                auto file_name = index_key(file->path().filename().native());
+                if (file_name.length() <= plugin_suffix.length() ||
+                    file_name.compare(file_name.length() - plugin_suffix.length(), plugin_suffix.length(), plugin_suffix) != 0)
+                    continue;
+                file_name.resize(file_name.length() - plugin_suffix.length());
+                _plugin_index.try_emplace(std::move(file_name), file->path().native());
+            }
         }
+        LOG(INFO, "Indexed {} plugins in {} mod folders in {}us", _plugin_index.size(), active_mod_folder_list.size(), elapsed_us(start));
+    }
+
+    void plugin_searcher::begin_batch() {
+        std::lock_guard<std::mutex> lock(_index_lock);
+        _in_batch = true;
+        _batch_rescanned = false;
+        if (!_indexed) return;  //the first lookup builds it
+
+        //Mods loaded or unloaded since the last batch, a plugin that moved would otherwise still be found in its old folder
+        auto folders = mod_folders(generate_pbo_list());
+        if (folders == active_mod_folder_list) return;
+        active_mod_folder_list = std::move(folders);
+        build_index();
+        _batch_rescanned = true;
+    }
+
+    void plugin_searcher::end_batch() {
+        std::lock_guard<std::mutex> lock(_index_lock);
+        _in_batch = false;
     }
 
     std::string plugin_searcher::get_command_line() {
@@ -56,38 +116,35 @@ namespace intercept::search {
         return GetCommandLineA();
     #endif
     }
-#ifdef __linux__
-    std::optional<std::string> plugin_searcher::find_extension(const std::string& name) {
-        LOG(INFO, "Searching for Extension: {}", name);
-        for (auto folder : active_mod_folder_list) {
-            std::string test_path = folder + "/intercept/" + name + ".so";
 
-            std::ifstream check_file(test_path);
-            if (check_file.good()) {
-                return test_path;
-            }
+    std::optional<plugin_searcher::string_type> plugin_searcher::find_extension(const string_type& name) {
+    #ifdef __linux__
+        LOG(INFO, "Searching for Extension: {}", name);
+    #endif
+        const auto start = std::chrono::steady_clock::now();
+        const auto key = index_key(name);
+        std::lock_guard<std::mutex> lock(_index_lock);
+
+        auto found = _plugin_index.find(key);
+        std::error_code error;
+        const bool stale = !_indexed || found == _plugin_index.end() || !std::filesystem::is_regular_file(found->second, error);
+        if (stale && !(_in_batch && _batch_rescanned)) {
+            //First lookup, new plugin, removed plugin or different mods, look again
+            active_mod_folder_list = mod_folders(generate_pbo_list());
+            build_index();
+            _batch_rescanned = _in_batch;
+            found = _plugin_index.find(key);
         }
-        LOG(ERROR, "Client plugin: {} was not found.", name);
-        return std::optional<std::string>();
-    }
-#else
-    std::optional<std::wstring> plugin_searcher::find_extension(const std::wstring& name) {
-        //LOG(INFO, L"Searching for Extension: {}", name);
-        for (auto folder : active_mod_folder_list) {
-        #if _WIN64 || __X86_64__
-            std::wstring test_path = folder + L"\\intercept\\" + name + L"_x64.dll";
-        #else
-            std::wstring test_path = folder + L"\\intercept\\" + name + L".dll";
-        #endif
 
-            std::ifstream check_file(test_path);
-            if (check_file.good()) {
-                return test_path;
-            }
+        if (found == _plugin_index.end()) {
+        #ifdef __linux__
+            LOG(ERROR, "Client plugin: {} was not found.", name);
+        #endif
+            return std::optional<string_type>();
         }
-        return std::optional<std::wstring>();
+        LOG(INFO, "Plugin lookup took {}us", elapsed_us(start));
+        return found->second;
     }
-#endif
 }
 
 
@@ -95,7 +152,6 @@ namespace intercept::search {
 
 
 
-
 #if __linux__
 #include <string.h>
 #include <stdio.h>
@@ -1,28 +1,56 @@
 #pragma once
 
 #include "shared.hpp"
+#include <mutex>
 #include <optional>
+#include <unordered_map>
 
 namespace intercept::search {
+    /*!
+    @brief Finds plugin binaries in the intercept folders of the loaded mods.
+
+    The plugins of all mod folders are indexed once by name, so repeated loads
+    (like -intreloadall doing every mission) are a hash lookup. begin_batch
+    walks the PBO list and rebuilds the index if the mod folders changed. A
+    plugin that isn't in the index also rebuilds it, between begin_batch and
+    end_batch that happens at most once, however many plugins are missing.
+    Safe to use from several threads.
+    */
     class plugin_searcher {
     public:
+    #ifdef __linux__
+        using string_type = std::string;
+    #else
+        using string_type = std::wstring;
+    #endif
+
         plugin_searcher();
         //This is here because it's easier to crossplatform n stuff
         static std::string get_command_line();
-    #ifdef __linux__
-        std::optional<std::string> find_extension(const std::string& name);
-    #else 
-        std::optional<std::wstring> find_extension(const std::wstring& name);
-    #endif
+        std::optional<string_type> find_extension(const string_type& name);
+
+        /*!@{
+        @brief Brackets the lookups of one batch of loads, they share a single rescan of the mod folders.
+        */
+        void begin_batch();
+        void end_batch();
+        //!@}
         
         
     private:
-    #ifdef __linux__
-        static std::vector<std::string> generate_pbo_list();
-        std::vector<std::string> active_mod_folder_list;
-    #else 
-        static std::vector<std::wstring> generate_pbo_list();
-        std::vector<std::wstring> active_mod_folder_list;
-    #endif
+        static std::vector<string_type> generate_pbo_list();
+        ///Unique folders of the mods the PBOs belong to, in the order they were first seen
+        static std::vector<string_type> mod_folders(const std::vector<string_type>& pbo_list_);
+
+        ///Called with _index_lock held
+        void build_index();
+
+        std::mutex _index_lock;
+        bool _indexed = false;
+        bool _in_batch = false;
+        bool _batch_rescanned = false;
+        std::vector<string_type> active_mod_folder_list;
+        ///Plugin name to path of its binary, the first mod folder that has one wins. Lowercase names on Windows.
+        std::unordered_map<string_type, string_type> _plugin_index;
     };
 }
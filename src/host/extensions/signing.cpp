@@ -4,6 +4,13 @@
 #include <wintrust.h>
 #include <windows.h>
 #pragma comment(lib, "crypt32.lib")
+#ifdef INTERCEPT_SIGNATURE_CACHE
+#include <bcrypt.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#pragma comment(lib, "bcrypt.lib")
+#endif
 
 //https://stackoverflow.com/questions/7241453/read-and-validate-certificate-from-executable
 /*
@@ -109,6 +116,59 @@ public:
     }
 };
 
+#ifdef INTERCEPT_SIGNATURE_CACHE
+namespace {
+    constexpr auto signature_cache_file = "intercept_signature_cache.dat";
+
+    //Hex SHA-256 of everything feed_ passes to its callback, empty if hashing failed
+    template <typename Feed>
+    std::string sha256(Feed&& feed_) {
+        ManagedObject<BCRYPT_ALG_HANDLE, BCryptCloseAlgorithmProvider> algorithm;
+        if (!BCRYPT_SUCCESS(BCryptOpenAlgorithmProvider(&algorithm, BCRYPT_SHA256_ALGORITHM, nullptr, 0))) return {};
+        ManagedObject<BCRYPT_HASH_HANDLE, BCryptDestroyHash> hash;
+        if (!BCRYPT_SUCCESS(BCryptCreateHash(algorithm, &hash, nullptr, 0, nullptr, 0, 0))) return {};
+
+        const bool fed = feed_([&hash](const char* data_, size_t size_) {
+            return BCRYPT_SUCCESS(BCryptHashData(hash, reinterpret_cast<PUCHAR>(const_cast<char*>(data_)), static_cast<ULONG>(size_), 0));
+        });
+        unsigned char digest[32];
+        if (!fed || !BCRYPT_SUCCESS(BCryptFinishHash(hash, digest, sizeof(digest), 0))) return {};
+
+        static constexpr char hex_digits[] = "0123456789abcdef";
+        std::string result;
+        result.reserve(sizeof(digest) * 2);
+        for (const auto byte : digest) {
+            result.push_back(hex_digits[byte >> 4]);
+            result.push_back(hex_digits[byte & 0xF]);
+        }
+        return result;
+    }
+
+    std::string sha256_file(std::wstring_view file_path_) {
+        std::ifstream file(std::wstring(file_path_), std::ios::binary);
+        if (!file) return {};
+        return sha256([&file](auto&& update_) {
+            std::vector<char> buffer(64 * 1024);
+            while (file) {
+                file.read(buffer.data(), buffer.size());
+                if (file.gcount() > 0 && !update_(buffer.data(), static_cast<size_t>(file.gcount()))) return false;
+            }
+            return file.eof();
+        });
+    }
+
+    std::string sha256_data(std::string_view data_) {
+        return sha256([data_](auto&& update_) { return update_(data_.data(), data_.length()); });
+    }
+
+    //The cache decides which plugins get core access, so it is bound to the current user through DPAPI.
+    //The core CA is mixed in, a cache written by a build with a different core CA doesn't open.
+    DATA_BLOB signature_cache_entropy() {
+        return DATA_BLOB{sizeof(coreCACert), coreCACert};
+    }
+}  // namespace
+#endif
+
 thread_local intercept::cert::signing::security_class intercept::cert::current_security_class = intercept::cert::signing::security_class::not_signed;
 
 std::pair<intercept::cert::signing::security_class, std::optional<std::string>> intercept::cert::signing::verifyCert(std::wstring_view file_path, types::r_string ca_cert) {
@@ -336,6 +396,95 @@ std::pair<intercept::cert::signing::security_class, std::optional<std::string>>
     return returnCode;
 }
 
+#ifdef INTERCEPT_SIGNATURE_CACHE
+std::pair<intercept::cert::signing::security_class, std::optional<std::string>> intercept::cert::signing::verifyCert_cached(std::wstring_view file_path, types::r_string ca_cert) {
+    std::error_code error;
+    const std::filesystem::path path(file_path);
+    const auto size = static_cast<uint64_t>(std::filesystem::file_size(path, error));
+    if (error) return verifyCert(file_path, ca_cert);
+    const auto write_time = static_cast<int64_t>(std::filesystem::last_write_time(path, error).time_since_epoch().count());
+    if (error) return verifyCert(file_path, ca_cert);
+
+    const auto file_hash = sha256_file(file_path);
+    if (file_hash.empty()) return verifyCert(file_path, ca_cert);
+    const auto ca_hash = sha256_data(std::string_view(ca_cert.data(), ca_cert.length()));
+    {
+        std::lock_guard<std::mutex> lock(_cache_lock);
+        if (!_cache_loaded) load_cache();
+        auto found = _cache.find(file_hash);
+        if (found != _cache.end() && found->second.ca_hash == ca_hash && found->second.size == size && found->second.write_time == write_time)
+            return {found->second.result, std::nullopt};
+    }
+
+    auto result = verifyCert(file_path, ca_cert);
+    if (result.first != security_class::not_signed) {
+        std::lock_guard<std::mutex> lock(_cache_lock);
+        _cache[file_hash] = cache_entry{ca_hash, size, write_time, result.first};
+        _cache_dirty = true;
+    }
+    return result;
+}
+
+//Called with _cache_lock held
+void intercept::cert::signing::load_cache() {
+    _cache_loaded = true;
+    std::ifstream file(signature_cache_file, std::ios::binary);
+    const std::string protected_data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (protected_data.empty()) return;
+
+    DATA_BLOB input{static_cast<DWORD>(protected_data.size()), reinterpret_cast<BYTE*>(const_cast<char*>(protected_data.data()))};
+    DATA_BLOB entropy = signature_cache_entropy();
+    DATA_BLOB output{};
+    if (!CryptUnprotectData(&input, nullptr, &entropy, nullptr, nullptr, CRYPTPROTECT_UI_FORBIDDEN, &output)) {
+        LOG(WARNING, "Signature cache could not be unprotected, e={}. Verifying all plugins.", GetLastError());
+        return;
+    }
+    ManagedObject<BYTE*, LocalFree> contents_data(output.pbData);
+    std::istringstream contents(std::string(reinterpret_cast<const char*>(output.pbData), output.cbData));
+
+    std::string line;
+    while (std::getline(contents, line)) {
+        std::istringstream fields(line);
+        std::string file_hash;
+        cache_entry entry;
+        int result = 0;
+        if (!(fields >> file_hash >> entry.ca_hash >> entry.size >> entry.write_time >> result)) continue;
+        if (result != static_cast<int>(security_class::self_signed) && result != static_cast<int>(security_class::core)) continue;
+        entry.result = static_cast<security_class>(result);
+        _cache[file_hash] = std::move(entry);
+    }
+}
+
+void intercept::cert::signing::save_cache() {
+    std::lock_guard<std::mutex> lock(_cache_lock);
+    if (!_cache_dirty) return;
+    std::ostringstream contents;
+    for (auto& [file_hash, entry] : _cache) {
+        contents << file_hash << ' ' << entry.ca_hash << ' ' << entry.size << ' ' << entry.write_time << ' ' << static_cast<int>(entry.result) << '\n';
+    }
+    const auto plain = contents.str();
+
+    DATA_BLOB input{static_cast<DWORD>(plain.size()), reinterpret_cast<BYTE*>(const_cast<char*>(plain.data()))};
+    DATA_BLOB entropy = signature_cache_entropy();
+    DATA_BLOB output{};
+    if (!CryptProtectData(&input, L"Intercept signature cache", &entropy, nullptr, nullptr, CRYPTPROTECT_UI_FORBIDDEN, &output)) {
+        LOG(ERROR, "Signature cache could not be protected, e={}", GetLastError());
+        return;
+    }
+    ManagedObject<BYTE*, LocalFree> protected_data(output.pbData);
+
+    std::ofstream file(signature_cache_file, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(output.pbData), output.cbData);
+    _cache_dirty = !file.good();
+}
+#else
+std::pair<intercept::cert::signing::security_class, std::optional<std::string>> intercept::cert::signing::verifyCert_cached(std::wstring_view file_path, types::r_string ca_cert) {
+    return verifyCert(file_path, ca_cert);
+}
+void intercept::cert::signing::save_cache() {}
+void intercept::cert::signing::load_cache() {}
+#endif
+
 /*
 #include "Windows.h"
 #include <future>
@@ -375,5 +524,10 @@ void intercept::cert::signing::debug_certs_in_store([[maybe_unused]] HCERTSTORE
 std::pair<intercept::cert::signing::security_class, std::optional<std::string>> intercept::cert::signing::verifyCert(std::wstring_view, types::r_string) {
     return {security_class::core, std::nullopt};
 }
+std::pair<intercept::cert::signing::security_class, std::optional<std::string>> intercept::cert::signing::verifyCert_cached(std::wstring_view file_path, types::r_string ca_cert) {
+    return verifyCert(file_path, ca_cert);
+}
+void intercept::cert::signing::save_cache() {}
+void intercept::cert::signing::load_cache() {}
 void intercept::cert::signing::debug_certs_in_store(void*) {}
 #endif
@@ -1,6 +1,8 @@
 #pragma once
 #include "shared.hpp"
 #include "shared/client_types.hpp"
+#include <mutex>
+#include <optional>
 
 #ifndef __linux__
 #include "Windows.h"
@@ -20,8 +22,41 @@ namespace intercept::cert {
             core
         };
         std::pair<intercept::cert::signing::security_class, std::optional<std::string>> verifyCert(std::wstring_view file_path, types::r_string ca_cert);
+
+        /*!
+        @brief verifyCert, but files that passed before and didn't change since skip the check.
+
+        A file counts as unchanged if its SHA-256, size and last write time, and the
+        SHA-256 of the CA certificate it was checked against, all match the cached
+        entry. Only successful verifications are cached. The cache file is protected
+        with DPAPI for the current user, a file that doesn't unprotect is ignored.
+        Safe to call from several threads at once.
+        The cache is only built with INTERCEPT_SIGNATURE_CACHE (CMake USE_SIGNATURE_CACHE),
+        otherwise this is verifyCert.
+        */
+        std::pair<intercept::cert::signing::security_class, std::optional<std::string>> verifyCert_cached(std::wstring_view file_path, types::r_string ca_cert);
+
+        /*!
+        @brief Writes the verification cache to disk if anything was added since it was loaded.
+        */
+        void save_cache();
     private:
         static void debug_certs_in_store(void* store);
+
+        struct cache_entry {
+            std::string ca_hash;
+            uint64_t size;
+            int64_t write_time;
+            security_class result;
+        };
+
+        void load_cache();
+
+        std::mutex _cache_lock;
+        bool _cache_loaded = false;
+        bool _cache_dirty = false;
+        ///Keyed by the SHA-256 of the plugin file
+        std::unordered_map<std::string, cache_entry> _cache;
     };
 
 #ifndef __linux__
@@ -0,0 +1,106 @@
+#include "watcher.hpp"
+#include <filesystem>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace intercept::search {
+    namespace {
+        std::filesystem::path folder_of(const plugin_watcher::string_type& file_) {
+            return std::filesystem::path(file_).parent_path();
+        }
+    }  // namespace
+
+#ifdef __linux__
+    plugin_watcher::~plugin_watcher() {
+        if (_inotify >= 0) close(_inotify);
+    }
+
+    void plugin_watcher::add(const string_type& file_) {
+        if (_inotify < 0) {
+            _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (_inotify < 0) {
+                LOG(ERROR, "inotify_init1() failed, e={}", errno);
+                return;
+            }
+        }
+        _files.try_emplace(file_);
+
+        //Watching the folder instead of the file also catches plugins that are replaced by a rename
+        const auto folder = folder_of(file_).string();
+        const int watch = inotify_add_watch(_inotify, folder.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (watch < 0) {
+            LOG(ERROR, "inotify_add_watch() failed on {}, e={}", folder, errno);
+            return;
+        }
+        _folders[watch] = folder;
+        LOG(INFO, "Watching {} for changes", file_);
+    }
+
+    void plugin_watcher::remove(const string_type& file_) {
+        //The folder watches stay, events for files that aren't watched anymore are ignored
+        _files.erase(file_);
+    }
+
+    void plugin_watcher::read_events() {
+        alignas(inotify_event) char buffer[4096];
+        for (;;) {
+            const auto length = read(_inotify, buffer, sizeof(buffer));
+            if (length <= 0) return;
+            for (auto position = buffer; position < buffer + length;) {
+                const auto event = reinterpret_cast<const inotify_event*>(position);
+                position += sizeof(inotify_event) + event->len;
+
+                auto folder = _folders.find(event->wd);
+                if (folder == _folders.end() || !event->len) continue;
+                auto file = _files.find((std::filesystem::path(folder->second) / event->name).string());
+                if (file != _files.end()) file->second = clock::now();
+            }
+        }
+    }
+#else
+    plugin_watcher::~plugin_watcher() {}
+
+    void plugin_watcher::add(const string_type& file_) {
+        _files.try_emplace(file_);
+        std::error_code error;
+        _write_times[file_] = std::filesystem::last_write_time(file_, error).time_since_epoch().count();
+    }
+
+    void plugin_watcher::remove(const string_type& file_) {
+        _files.erase(file_);
+        _write_times.erase(file_);
+    }
+#endif
+
+    std::vector<plugin_watcher::string_type> plugin_watcher::poll() {
+        std::vector<string_type> changed;
+        if (_files.empty()) return changed;
+        const auto now = clock::now();
+
+    #ifdef __linux__
+        if (_inotify < 0) return changed;
+        read_events();
+    #else
+        if (now - _last_check >= settle_time) {
+            _last_check = now;
+            for (auto& [file, write_time] : _write_times) {
+                std::error_code error;
+                const auto current = std::filesystem::last_write_time(file, error).time_since_epoch().count();
+                if (error || current == write_time) continue;
+                write_time = current;
+                _files[file] = now;
+            }
+        }
+    #endif
+
+        for (auto& [file, changed_at] : _files) {
+            if (changed_at == clock::time_point() || now - changed_at < settle_time) continue;
+            changed_at = clock::time_point();
+            changed.push_back(file);
+        }
+        return changed;
+    }
+}  // namespace intercept::search
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "shared.hpp"
+#include "search.hpp"
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace intercept::search {
+    /*!
+    @brief Watches plugin binaries and reports the ones that were rewritten.
+
+    Uses inotify on the folders of the watched files on Linux, and compares the
+    last write times twice a second on Windows. A file is only reported after
+    it didn't change for settle_time, so a linker that is still writing doesn't
+    get its half written output loaded.
+    */
+    class plugin_watcher {
+    public:
+        using string_type = plugin_searcher::string_type;
+        static constexpr std::chrono::milliseconds settle_time{500};
+
+        plugin_watcher() noexcept = default;
+        ~plugin_watcher();
+        plugin_watcher(const plugin_watcher &) = delete;
+        plugin_watcher &operator=(const plugin_watcher &) = delete;
+
+        void add(const string_type &file_);
+        void remove(const string_type &file_);
+
+        /*!
+        @brief Returns the watched files that changed and settled since the last call.
+        */
+        std::vector<string_type> poll();
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        ///Watched file to the time it was last seen changing, time_point() while unchanged
+        std::map<string_type, clock::time_point> _files;
+    #ifdef __linux__
+        void read_events();
+
+        int _inotify = -1;
+        ///inotify watch descriptor to the folder it watches
+        std::map<int, std::string> _folders;
+    #else
+        ///Last write time of every watched file, as of the last check
+        std::map<string_type, int64_t> _write_times;
+        clock::time_point _last_check;
+    #endif
+    };
+}  // namespace intercept::search
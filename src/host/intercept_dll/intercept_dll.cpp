@@ -51,9 +51,9 @@ void __stdcall RVExtension(char *output, int outputSize, const char *function) {
 
     std::string_view command = cmd.value();
 
-    std::string argument_str;
+    std::string_view argument_str;
     if (command.length() > 1 && input.length() > command.length() + 1) {
-        argument_str = input.substr(command.length() + 1, input.length() + 1 - command.length());
+        argument_str = input.substr(command.length() + 1);
     }
     intercept::arguments _args(argument_str);
 
@@ -71,20 +71,30 @@ namespace intercept {
     }
 
     game_value eventhandlers::client_eventhandler(game_value_parameter left_arg, game_value_parameter right_arg) {
-        r_string moduleName = left_arg[0];
+        const auto& moduleRef = left_arg[0];
         const uint8_t ehType = static_cast<int>(left_arg[1]);
         const float uidf = left_arg[2];
         const int32_t uid = static_cast<int32_t>(uidf);
         //uint32_t handle = static_cast<uint32_t>(static_cast<float>(left_arg[3]));
 
-        for (auto& module : extensions::get().modules()) {
-            if (module.second.functions.client_eventhandler && module.second.name == static_cast<std::string_view>(moduleName)) {
-                game_value ret{};
-                module.second.functions.client_eventhandler(ret, ehType, uid, left_arg[3], right_arg[0]);
-                return ret;
+        module::entry* target = nullptr;
+        if (moduleRef.type() == game_data_number::type_def) {
+            target = extensions::get().module_by_id(static_cast<uint32_t>(static_cast<float>(moduleRef)));
+        } else {
+            //Plugins built against an older client send their name instead of their id
+            const r_string moduleName = moduleRef;
+            for (auto& module : extensions::get().modules()) {
+                if (module.second.name == static_cast<std::string_view>(moduleName)) {
+                    target = &module.second;
+                    break;
+                }
             }
         }
-        return {};
+
+        if (!target || !target->functions.client_eventhandler) return {};
+        game_value ret{};
+        target->functions.client_eventhandler(ret, ehType, uid, left_arg[3], right_arg[0]);
+        return ret;
     }
 
     void eventhandlers::pre_start(game_value_parameter) {
@@ -133,78 +143,267 @@ namespace intercept {
             if (module.second.functions.mission_ended) module.second.functions.mission_ended();
         }
     }
+
+//Arguments are converted once, then passed to every module that exports the handler
 #define EH_START(x) void eventhandlers::x(game_value_parameter args_) {\
-        for (auto& module : extensions::get().modules()) {\
-            if (module.second.eventhandlers.x) module.second.eventhandlers.x
+        auto& subscribers = extensions::get().eventhandler_subscribers().x;\
+        if (subscribers.empty()) return;
 
-#define EH_END ;\
-        }\
+#define EH_DISPATCH(...) \
+        for (auto& subscriber : subscribers) subscriber(__VA_ARGS__);\
     }
 
-    
-    EH_START(anim_changed)(static_cast<object &>(args_[0]), static_cast<r_string>(args_[1]))EH_END
-    EH_START(anim_done)(static_cast<object &>(args_[0]), static_cast<r_string>(args_[1]))EH_END
-    EH_START(anim_state_changed)(static_cast<object &>(args_[0]), static_cast<r_string>(args_[1]))EH_END
-    EH_START(container_closed)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]))EH_END
-    EH_START(controls_shifted)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<object &>(args_[2]))EH_END
-    EH_START(dammaged)(static_cast<object &>(args_[0]), static_cast<r_string>(args_[1]), static_cast<float>(args_[2]))EH_END
-    EH_START(engine)(static_cast<object &>(args_[0]), static_cast<bool>(args_[1]))EH_END
-    EH_START(epe_contact)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<r_string>(args_[2]), static_cast<r_string>(args_[3]), static_cast<float>(args_[4]))EH_END
-    EH_START(epe_contact_end)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<r_string>(args_[2]), static_cast<r_string>(args_[3]), static_cast<float>(args_[4]))EH_END
-    EH_START(epe_contact_start)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<r_string>(args_[2]), static_cast<r_string>(args_[3]), static_cast<float>(args_[4]))EH_END
-    EH_START(explosion)(static_cast<object &>(args_[0]), static_cast<float>(args_[1]))EH_END
-    
-    EH_START(fired)(static_cast<object &>(args_[0]), static_cast<r_string>(args_[1]), static_cast<r_string>(args_[2]), static_cast<r_string>(args_[3]), static_cast<r_string>(args_[4]), static_cast<r_string>(args_[5]), static_cast<object &>(args_[6]))EH_END
-    
-    EH_START(fired_near)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<float>(args_[2]), static_cast<r_string>(args_[3]), static_cast<r_string>(args_[4]), static_cast<r_string>(args_[5]), static_cast<r_string>(args_[6]))EH_END
-    EH_START(fuel)(static_cast<object &>(args_[0]), static_cast<bool>(args_[1]))EH_END
-    EH_START(gear)(static_cast<object &>(args_[0]), static_cast<bool>(args_[1]))EH_END
-    //EH_START(get_in)(static_cast<object &>(args_[0]), static_cast<r_string>(args_[1]), static_cast<object &>(args_[2]), rv_turret_path turret_path)EH_END
-
-    void eventhandlers::get_in(game_value_parameter args_) {
-        for (auto& module : extensions::get().modules()) {
-            if (module.second.eventhandlers.get_in) {
-                module.second.eventhandlers.get_in(static_cast<object &>(args_[0]), static_cast<r_string>(args_[1]), static_cast<object &>(args_[2]), rv_turret_path(args_[3]));
-            }
-        }
-    }
+    EH_START(anim_changed)
+        auto& unit = static_cast<object &>(args_[0]);
+        const auto anim_name = static_cast<r_string>(args_[1]);
+    EH_DISPATCH(unit, anim_name)
 
-    //EH_START(get_out)(static_cast<object &>(args_[0]), static_cast<rv_string>(args_[REPLACE_ME]), static_cast<object &>(args_[REPLACE_ME]), rv_turret_path turret_path)EH_END
+    EH_START(anim_done)
+        auto& unit = static_cast<object &>(args_[0]);
+        const auto anim_name = static_cast<r_string>(args_[1]);
+    EH_DISPATCH(unit, anim_name)
 
-    void eventhandlers::get_out(game_value_parameter args_) {
-        for (auto& module : extensions::get().modules()) {
-            if (module.second.eventhandlers.get_out) {
-                module.second.eventhandlers.get_out(static_cast<object &>(args_[0]), static_cast<r_string>(args_[1]), static_cast<object &>(args_[2]), rv_turret_path(args_[3]));
-            }
-        }
-    }
+    EH_START(anim_state_changed)
+        auto& unit = static_cast<object &>(args_[0]);
+        const auto anim_name = static_cast<r_string>(args_[1]);
+    EH_DISPATCH(unit, anim_name)
+
+    EH_START(container_closed)
+        auto& container = static_cast<object &>(args_[0]);
+        auto& player = static_cast<object &>(args_[1]);
+    EH_DISPATCH(container, player)
+
+    EH_START(controls_shifted)
+        auto& vehicle = static_cast<object &>(args_[0]);
+        auto& new_controller = static_cast<object &>(args_[1]);
+        auto& old_controller = static_cast<object &>(args_[2]);
+    EH_DISPATCH(vehicle, new_controller, old_controller)
+
+    EH_START(dammaged)
+        auto& unit = static_cast<object &>(args_[0]);
+        const auto selection_name = static_cast<r_string>(args_[1]);
+        const auto damage = static_cast<float>(args_[2]);
+    EH_DISPATCH(unit, selection_name, damage)
+
+    EH_START(engine)
+        auto& vehicle = static_cast<object &>(args_[0]);
+        const auto engine_state = static_cast<bool>(args_[1]);
+    EH_DISPATCH(vehicle, engine_state)
+
+    EH_START(epe_contact)
+        auto& object1 = static_cast<object &>(args_[0]);
+        auto& object2 = static_cast<object &>(args_[1]);
+        const auto selection1 = static_cast<r_string>(args_[2]);
+        const auto selection2 = static_cast<r_string>(args_[3]);
+        const auto force = static_cast<float>(args_[4]);
+    EH_DISPATCH(object1, object2, selection1, selection2, force)
+
+    EH_START(epe_contact_end)
+        auto& object1 = static_cast<object &>(args_[0]);
+        auto& object2 = static_cast<object &>(args_[1]);
+        const auto selection1 = static_cast<r_string>(args_[2]);
+        const auto selection2 = static_cast<r_string>(args_[3]);
+        const auto force = static_cast<float>(args_[4]);
+    EH_DISPATCH(object1, object2, selection1, selection2, force)
+
+    EH_START(epe_contact_start)
+        auto& object1 = static_cast<object &>(args_[0]);
+        auto& object2 = static_cast<object &>(args_[1]);
+        const auto selection1 = static_cast<r_string>(args_[2]);
+        const auto selection2 = static_cast<r_string>(args_[3]);
+        const auto force = static_cast<float>(args_[4]);
+    EH_DISPATCH(object1, object2, selection1, selection2, force)
+
+    EH_START(explosion)
+        auto& vehicle = static_cast<object &>(args_[0]);
+        const auto damage = static_cast<float>(args_[1]);
+    EH_DISPATCH(vehicle, damage)
+
+    EH_START(fired)
+        auto& unit = static_cast<object &>(args_[0]);
+        const auto weapon = static_cast<r_string>(args_[1]);
+        const auto muzzle = static_cast<r_string>(args_[2]);
+        const auto mode = static_cast<r_string>(args_[3]);
+        const auto ammo = static_cast<r_string>(args_[4]);
+        const auto magazine = static_cast<r_string>(args_[5]);
+        auto& projectile = static_cast<object &>(args_[6]);
+    EH_DISPATCH(unit, weapon, muzzle, mode, ammo, magazine, projectile)
+
+    EH_START(fired_near)
+        auto& unit = static_cast<object &>(args_[0]);
+        auto& firer = static_cast<object &>(args_[1]);
+        const auto distance = static_cast<float>(args_[2]);
+        const auto weapon = static_cast<r_string>(args_[3]);
+        const auto muzzle = static_cast<r_string>(args_[4]);
+        const auto mode = static_cast<r_string>(args_[5]);
+        const auto ammo = static_cast<r_string>(args_[6]);
+    EH_DISPATCH(unit, firer, distance, weapon, muzzle, mode, ammo)
+
+    EH_START(fuel)
+        auto& vehicle = static_cast<object &>(args_[0]);
+        const auto fuel_state = static_cast<bool>(args_[1]);
+    EH_DISPATCH(vehicle, fuel_state)
+
+    EH_START(gear)
+        auto& vehicle = static_cast<object &>(args_[0]);
+        const auto gear_state = static_cast<bool>(args_[1]);
+    EH_DISPATCH(vehicle, gear_state)
+
+    EH_START(get_in)
+        auto& vehicle = static_cast<object &>(args_[0]);
+        const auto position = static_cast<r_string>(args_[1]);
+        auto& unit = static_cast<object &>(args_[2]);
+        const rv_turret_path turret_path(args_[3]);
+    EH_DISPATCH(vehicle, position, unit, turret_path)
+
+    EH_START(get_out)
+        auto& vehicle = static_cast<object &>(args_[0]);
+        const auto position = static_cast<r_string>(args_[1]);
+        auto& unit = static_cast<object &>(args_[2]);
+        const rv_turret_path turret_path(args_[3]);
+    EH_DISPATCH(vehicle, position, unit, turret_path)
+
+    EH_START(handle_damage)
+        auto& unit = static_cast<object &>(args_[0]);
+        const auto selection_name = static_cast<r_string>(args_[1]);
+        const auto damage = static_cast<float>(args_[2]);
+        auto& source = static_cast<object &>(args_[3]);
+        const auto projectile = static_cast<r_string>(args_[4]);
+        const auto hit_part_index = static_cast<int>(args_[5]);
+    EH_DISPATCH(unit, selection_name, damage, source, projectile, hit_part_index)
+
+    EH_START(handle_heal)
+        auto& unit = static_cast<object &>(args_[0]);
+        auto& healer = static_cast<object &>(args_[1]);
+        const auto healer_can_heal = static_cast<bool>(args_[2]);
+    EH_DISPATCH(unit, healer, healer_can_heal)
+
+    EH_START(handle_rating)
+        auto& unit = static_cast<object &>(args_[0]);
+        const auto rating = static_cast<float>(args_[1]);
+    EH_DISPATCH(unit, rating)
+
+    EH_START(handle_score)
+        auto& unit = static_cast<object &>(args_[0]);
+        auto& obj = static_cast<object &>(args_[1]);
+        const auto score = static_cast<float>(args_[2]);
+    EH_DISPATCH(unit, obj, score)
+
+    EH_START(hit)
+        auto& unit = static_cast<object &>(args_[0]);
+        auto& caused_by = static_cast<object &>(args_[1]);
+        const auto damage = static_cast<float>(args_[2]);
+    EH_DISPATCH(unit, caused_by, damage)
+
+    //hit_part is not forwarded yet
+
+    EH_START(init)
+        auto& unit = static_cast<object &>(args_[0]);
+    EH_DISPATCH(unit)
+
+    EH_START(incoming_missile)
+        auto& unit = static_cast<object &>(args_[0]);
+        const auto ammo = static_cast<r_string>(args_[1]);
+        auto& firer = static_cast<object &>(args_[2]);
+    EH_DISPATCH(unit, ammo, firer)
+
+    EH_START(inventory_closed)
+        auto& obj = static_cast<object &>(args_[0]);
+        auto& container = static_cast<object &>(args_[1]);
+    EH_DISPATCH(obj, container)
+
+    EH_START(inventory_opened)
+        auto& obj = static_cast<object &>(args_[0]);
+        auto& container = static_cast<object &>(args_[1]);
+    EH_DISPATCH(obj, container)
+
+    EH_START(killed)
+        auto& unit = static_cast<object &>(args_[0]);
+        auto& killer = static_cast<object &>(args_[1]);
+    EH_DISPATCH(unit, killer)
+
+    EH_START(landed_touch_down)
+        auto& plane = static_cast<object &>(args_[0]);
+        const auto airport_id = static_cast<int>(args_[1]);
+    EH_DISPATCH(plane, airport_id)
+
+    EH_START(landed_stopped)
+        auto& plane = static_cast<object &>(args_[0]);
+        const auto airport_id = static_cast<int>(args_[1]);
+    EH_DISPATCH(plane, airport_id)
+
+    EH_START(local)
+        auto& obj = static_cast<object &>(args_[0]);
+        const auto is_local = static_cast<bool>(args_[1]);
+    EH_DISPATCH(obj, is_local)
+
+    EH_START(post_reset)
+    EH_DISPATCH()
+
+    EH_START(put)
+        auto& unit = static_cast<object &>(args_[0]);
+        auto& container = static_cast<object &>(args_[1]);
+        const auto item = static_cast<r_string>(args_[2]);
+    EH_DISPATCH(unit, container, item)
+
+    EH_START(respawn)
+        auto& unit = static_cast<object &>(args_[0]);
+        auto& corpse = static_cast<object &>(args_[1]);
+    EH_DISPATCH(unit, corpse)
+
+    EH_START(rope_attach)
+        auto& object1 = static_cast<object &>(args_[0]);
+        auto& rope = static_cast<object &>(args_[1]);
+        auto& object2 = static_cast<object &>(args_[2]);
+    EH_DISPATCH(object1, rope, object2)
+
+    EH_START(rope_break)
+        auto& object1 = static_cast<object &>(args_[0]);
+        auto& rope = static_cast<object &>(args_[1]);
+        auto& object2 = static_cast<object &>(args_[2]);
+    EH_DISPATCH(object1, rope, object2)
+
+    EH_START(seat_switched)
+        auto& vehicle = static_cast<object &>(args_[0]);
+        auto& unit1 = static_cast<object &>(args_[1]);
+        auto& unit2 = static_cast<object &>(args_[2]);
+    EH_DISPATCH(vehicle, unit1, unit2)
+
+    EH_START(sound_played)
+        auto& unit = static_cast<object &>(args_[0]);
+        const auto sound_code = static_cast<int>(args_[1]);
+    EH_DISPATCH(unit, sound_code)
+
+    EH_START(take)
+        auto& unit = static_cast<object &>(args_[0]);
+        auto& container = static_cast<object &>(args_[1]);
+        const auto item = static_cast<r_string>(args_[2]);
+    EH_DISPATCH(unit, container, item)
+
+    EH_START(task_set_as_current)
+        auto& unit = static_cast<object &>(args_[0]);
+        auto& current_task = static_cast<task &>(args_[1]);
+    EH_DISPATCH(unit, current_task)
+
+    EH_START(weapon_assembled)
+        auto& unit = static_cast<object &>(args_[0]);
+        auto& weapon = static_cast<object &>(args_[1]);
+    EH_DISPATCH(unit, weapon)
+
+    EH_START(weapon_disassembled)
+        auto& unit = static_cast<object &>(args_[0]);
+        auto& primary_bag = static_cast<object &>(args_[1]);
+        auto& secondary_bag = static_cast<object &>(args_[2]);
+    EH_DISPATCH(unit, primary_bag, secondary_bag)
+
+    EH_START(weapon_deployed)
+        auto& unit = static_cast<object &>(args_[0]);
+        const auto is_deployed = static_cast<bool>(args_[1]);
+    EH_DISPATCH(unit, is_deployed)
+
+    EH_START(weapon_rested)
+        auto& unit = static_cast<object &>(args_[0]);
+        const auto is_rested = static_cast<bool>(args_[1]);
+    EH_DISPATCH(unit, is_rested)
 
-    EH_START(handle_damage)(static_cast<object &>(args_[0]), static_cast<r_string>(args_[1]), static_cast<float>(args_[2]), static_cast<object &>(args_[3]), static_cast<r_string>(args_[4]), static_cast<int>(args_[5]))EH_END
-    EH_START(handle_heal)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<bool>(args_[2]))EH_END
-    EH_START(handle_rating)(static_cast<object &>(args_[0]), static_cast<float>(args_[1]))EH_END
-    EH_START(handle_score)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<float>(args_[2]))EH_END
-    EH_START(hit)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<float>(args_[2]))EH_END
-    //EH_START(hit_part)(std::vector<hit_part_data> data_)EH_END
-    EH_START(init)(static_cast<object &>(args_[0]))EH_END
-    EH_START(incoming_missile)(static_cast<object &>(args_[0]), static_cast<r_string>(args_[1]), static_cast<object &>(args_[2]))EH_END
-    EH_START(inventory_closed)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]))EH_END
-    EH_START(inventory_opened)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]))EH_END
-    EH_START(killed)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]))EH_END
-    EH_START(landed_touch_down)(static_cast<object &>(args_[0]), static_cast<int>(args_[1]))EH_END
-    EH_START(landed_stopped)(static_cast<object &>(args_[0]), static_cast<int>(args_[1]))EH_END
-    EH_START(local)(static_cast<object &>(args_[0]), static_cast<bool>(args_[1]))EH_END
-    EH_START(post_reset)()EH_END
-    EH_START(put)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<r_string>(args_[2]))EH_END
-    EH_START(respawn)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]))EH_END
-    EH_START(rope_attach)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<object &>(args_[2]))EH_END
-    EH_START(rope_break)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<object &>(args_[2]))EH_END
-    EH_START(seat_switched)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<object &>(args_[2]))EH_END
-    EH_START(sound_played)(static_cast<object &>(args_[0]), static_cast<int>(args_[1]))EH_END
-    EH_START(take)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<r_string>(args_[2]))EH_END
-    EH_START(task_set_as_current)(static_cast<object &>(args_[0]), static_cast<task &>(args_[1]))EH_END
-    EH_START(weapon_assembled)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]))EH_END
-    EH_START(weapon_disassembled)(static_cast<object &>(args_[0]), static_cast<object &>(args_[1]), static_cast<object &>(args_[2]))EH_END
-    EH_START(weapon_deployed)(static_cast<object &>(args_[0]), static_cast<bool>(args_[1]))EH_END
-    EH_START(weapon_rested)(static_cast<object &>(args_[0]), static_cast<bool>(args_[1]))EH_END
-    
 }
@@ -28,12 +28,30 @@ namespace intercept {
     */
     static thread_local bool _main_thread = false;
 
-    invoker::invoker() : _thread_count(0), _patched(false), _attached(false) {
+    /*!
+    @brief Fraction of the measured frame time the invoke period may use at most.
+    */
+    static constexpr float invoke_budget_frame_fraction = 0.15f;
+
+    static uint32_t elapsed_us(std::chrono::steady_clock::time_point start_) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_);
+        return static_cast<uint32_t>(std::min<std::chrono::microseconds::rep>(elapsed.count(), UINT32_MAX));
+    }
+
+    invoker::invoker() : _thread_count(0), _thread_waiting_for_lock_count(0), _invoke_queue(nullptr),
+        _invoke_budget_min(500us), _invoke_budget_max(3ms), _invoke_budget_per_thread(250us),
+        _frame_time(16ms), _patched(false), _attached(false) {
         _main_thread = true;
     }
 
     invoker::~invoker() {
-
+        //Plugins are gone by now, their callbacks can't be called anymore
+        for (auto job : {_invoke_queue.exchange(nullptr), _invoke_backlog}) {
+            while (job) {
+                std::unique_ptr<invoke_job> current(job);
+                job = job->next;
+            }
+        }
     }
 
     void invoker::attach_controller() {
@@ -44,6 +62,8 @@ namespace intercept {
             controller::get().add("invoker_begin_register"sv, std::bind(&intercept::invoker::invoker_begin_register, this, std::placeholders::_1, std::placeholders::_2));
             controller::get().add("invoker_register"sv, std::bind(&intercept::invoker::invoker_register, this, std::placeholders::_1, std::placeholders::_2));
             controller::get().add("invoker_end_register"sv, std::bind(&intercept::invoker::invoker_end_register, this, std::placeholders::_1, std::placeholders::_2));
+            controller::get().add("invoker_set_budget"sv, std::bind(&intercept::invoker::invoker_set_budget, this, std::placeholders::_1, std::placeholders::_2));
+            controller::get().add("invoker_metrics"sv, std::bind(&intercept::invoker::invoker_metrics, this, std::placeholders::_1, std::placeholders::_2));
             eventhandlers::get().initialize();
         }
     }
@@ -77,24 +97,108 @@ namespace intercept {
     }
 
     bool invoker::do_invoke_period() {
+        extensions::get().reload_changed();
+        _drain_invoke_queue();
         {
             _invoker_unlock period_lock(this, true);
-            if (_thread_waiting_for_lock_count) std::this_thread::sleep_for(std::chrono::nanoseconds(10)); //Sleep some, to allow other threads to catch the lock
-            const long timeout = clock() + 3;
-            while (_thread_count > 0 && clock() < timeout) std::this_thread::sleep_for(std::chrono::microseconds(20));
+            const auto now = std::chrono::steady_clock::now();
+            const auto budget = _invoke_budget(now);
+            //Threads that were waiting for the window count as queued work, so we stay open until they are through
+            std::unique_lock<std::mutex> lock(_state_mutex);
+            _invoke_drained.wait_until(lock, now + budget, [this] {
+                return _thread_count == 0 && _thread_waiting_for_lock_count == 0;
+            });
+            const auto used = elapsed_us(now);
+            _window_used_metric.record(used);
+            _window_utilization_metric.record(static_cast<uint32_t>(used * 100 / std::max<std::chrono::microseconds::rep>(budget.count(), 1)));
         }
         {
             _invoker_unlock on_frame_lock(this);
             // do the per-frame handler here.
             for (auto& module : extensions::get().modules()) {
                 if (module.second.functions.on_frame) {
+                    auto& metric = _on_frame_metric(module.first);
+                    const auto start = std::chrono::steady_clock::now();
                     module.second.functions.on_frame();
+                    metric.record(elapsed_us(start));
                 }
             }
         }
         return true;
     }
 
+    std::chrono::microseconds invoker::_invoke_budget(std::chrono::steady_clock::time_point now_) {
+        using namespace std::chrono;
+        if (_last_invoke_period != steady_clock::time_point()) {
+            //exponential moving average, so a single hitch doesn't blow up the budget
+            const auto elapsed = duration_cast<microseconds>(now_ - _last_invoke_period);
+            _frame_time = (_frame_time * 7 + elapsed) / 8;
+        }
+        _last_invoke_period = now_;
+
+        const uint32_t demand = _thread_count + _thread_waiting_for_lock_count;
+        auto budget = std::min(_invoke_budget_per_thread * std::max(demand, 1u),
+            duration_cast<microseconds>(_frame_time * invoke_budget_frame_fraction));
+        return std::clamp(budget, _invoke_budget_min, _invoke_budget_max);
+    }
+
+    void invoker::set_invoke_budget(std::chrono::microseconds min_, std::chrono::microseconds max_) {
+        if (max_ < min_) std::swap(min_, max_);
+        std::lock_guard<std::mutex> lock(_state_mutex);
+        _invoke_budget_min = min_;
+        _invoke_budget_max = max_;
+        LOG(INFO, "Invoke budget set to {}us - {}us", min_.count(), max_.count());
+    }
+
+    bool invoker::invoker_set_budget(const arguments & args_, std::string & result_) {
+        if (args_.size() < 2) return false;
+        set_invoke_budget(std::chrono::microseconds(args_.as_uint32(0)), std::chrono::microseconds(args_.as_uint32(1)));
+        result_ = "1";
+        return true;
+    }
+
+    histogram& invoker::_on_frame_metric(const std::string& module_name_) {
+        std::lock_guard<std::mutex> lock(_metrics_lock);
+        return _on_frame_metrics.try_emplace(module_name_).first->second;
+    }
+
+    auto_array<invoker_metric> invoker::get_metrics(bool reset_) {
+        auto_array<invoker_metric> metrics;
+        auto add_metric = [&metrics, reset_](std::string_view name_, histogram& histogram_) {
+            invoker_metric metric;
+            metric.name = r_string(name_);
+            metric.count = histogram_.count();
+            metric.p50 = histogram_.percentile(50.0);
+            metric.p99 = histogram_.percentile(99.0);
+            metric.max = histogram_.max();
+            metrics.emplace_back(std::move(metric));
+            if (reset_) histogram_.reset();
+        };
+
+        add_metric("lock_wait_us"sv, _lock_wait_metric);
+        add_metric("window_used_us"sv, _window_used_metric);
+        add_metric("window_utilization_pct"sv, _window_utilization_metric);
+        std::lock_guard<std::mutex> lock(_metrics_lock);
+        for (auto& module : _on_frame_metrics)
+            add_metric("on_frame_us:" + module.first, module.second);
+        return metrics;
+    }
+
+    bool invoker::invoker_metrics(const arguments & args_, std::string & result_) {
+        const bool reset = args_.size() > 0 && args_.as_string(0) == "reset"sv;
+        std::stringstream ss;
+        ss << "[";
+        bool first = true;
+        for (auto& metric : get_metrics(reset)) {
+            if (!first) ss << ",";
+            first = false;
+            ss << "[\"" << metric.name << "\"," << metric.count << "," << metric.p50 << "," << metric.p99 << "," << metric.max << "]";
+        }
+        ss << "]";
+        result_ = ss.str();
+        return true;
+    }
+
     void invoker::init_file_bank_list() {
 
         class file {
@@ -281,6 +385,115 @@ namespace intercept {
         return game_value();
     }
 
+    void invoker::invoke_async(uint32_t module_id_, const nular_function function_, invoke_async_callback callback_, void *user_data_) {
+        auto job = std::make_unique<invoke_job>();
+        job->type = invoke_job::call_type::nular;
+        job->function.nular = function_;
+        job->callback = callback_;
+        job->user_data = user_data_;
+        job->module_id = module_id_;
+        _enqueue(std::move(job));
+    }
+
+    void invoker::invoke_async(uint32_t module_id_, const unary_function function_, game_value right_, invoke_async_callback callback_, void *user_data_) {
+        auto job = std::make_unique<invoke_job>();
+        job->type = invoke_job::call_type::unary;
+        job->function.unary = function_;
+        job->right = std::move(right_);
+        job->callback = callback_;
+        job->user_data = user_data_;
+        job->module_id = module_id_;
+        _enqueue(std::move(job));
+    }
+
+    void invoker::invoke_async(uint32_t module_id_, const binary_function function_, game_value left_, game_value right_, invoke_async_callback callback_, void *user_data_) {
+        auto job = std::make_unique<invoke_job>();
+        job->type = invoke_job::call_type::binary;
+        job->function.binary = function_;
+        job->left = std::move(left_);
+        job->right = std::move(right_);
+        job->callback = callback_;
+        job->user_data = user_data_;
+        job->module_id = module_id_;
+        _enqueue(std::move(job));
+    }
+
+    void invoker::complete_async_jobs(uint32_t module_id_) {
+        _take_invoke_queue();
+        invoke_job* completed = nullptr;
+        invoke_job** completed_tail = &completed;
+        for (auto link = &_invoke_backlog; *link;) {
+            auto job = *link;
+            if (job->module_id != module_id_) {
+                link = &job->next;
+                continue;
+            }
+            *link = job->next;
+            job->next = nullptr;
+            *completed_tail = job;
+            completed_tail = &job->next;
+        }
+        _invoke_queue_execute(completed);
+    }
+
+    void invoker::_enqueue(std::unique_ptr<invoke_job> job_) {
+        invoke_job* job = job_.release();
+        if (_main_thread) {
+            //We already own the engine, no point in waiting for the next frame
+            job->next = nullptr;
+            _invoke_queue_execute(job);
+            return;
+        }
+
+        job->next = _invoke_queue.load(std::memory_order_relaxed);
+        while (!_invoke_queue.compare_exchange_weak(job->next, job, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    void invoker::_drain_invoke_queue() {
+        _take_invoke_queue();
+        auto jobs = _invoke_backlog;
+        _invoke_backlog = nullptr;
+        _invoke_queue_execute(jobs);
+    }
+
+    void invoker::_take_invoke_queue() {
+        auto job = _invoke_queue.exchange(nullptr, std::memory_order_acquire);
+        if (!job) return;
+
+        //The queue is a stack, reverse it to get submission order
+        invoke_job* ordered = nullptr;
+        while (job) {
+            auto next = job->next;
+            job->next = ordered;
+            ordered = job;
+            job = next;
+        }
+        auto tail = &_invoke_backlog;
+        while (*tail) tail = &(*tail)->next;
+        *tail = ordered;
+    }
+
+    void invoker::_invoke_queue_execute(invoke_job* job_) {
+        while (job_) {
+            std::unique_ptr<invoke_job> current(job_);
+            job_ = job_->next;
+            game_value result;
+            switch (current->type) {
+                case invoke_job::call_type::nular:
+                    result = invoke_raw_nolock(current->function.nular);
+                    break;
+                case invoke_job::call_type::unary:
+                    result = invoke_raw_nolock(current->function.unary, current->right);
+                    break;
+                case invoke_job::call_type::binary:
+                    result = invoke_raw_nolock(current->function.binary, current->left, current->right);
+                    break;
+            }
+            if (current->callback)
+                current->callback(current->user_data, result);
+        }
+    }
+
     value_type invoker::get_type(const game_value &value_) {
         return value_.type();
     }
@@ -438,22 +651,24 @@ namespace intercept {
     void invoker::lock() {
         
         if (_main_thread) return;
-        
+        const auto wait_start = std::chrono::steady_clock::now();
         //If the thread is already locked. We don't want to check if we are allowed to lock.
         //This would deadlock if the invoker wants to give control back to Engine but a thread needs to recursively
         //lock the invoker again before it can unlock it's first lock.
         //It waits on the second lock but can't lock because invoker_unlock is trying to give control to engine. So it forbids new locks.
         //But thread needs to lock it so it can unlock the first lock.
         if (_thread_count == 0) {
-            ++_thread_waiting_for_lock_count; //Make sure that invoker gives us atleast SOME time to catch the open window
+            ++_thread_waiting_for_lock_count; //Keeps the invoke period open until we caught the window
             std::unique_lock<std::mutex> lock(_state_mutex);
             _invoke_condition.wait(lock, [] {return invoker_accessible_all; });
             _invoke_mutex.lock();
+            ++_thread_count; //increment before leaving the waiting state, so the period never sees us as neither
             --_thread_waiting_for_lock_count;
         } else {
             _invoke_mutex.lock();
+            ++_thread_count;
         }
-        ++_thread_count;
+        _lock_wait_metric.record(elapsed_us(wait_start));
     #ifdef _DEBUG
         LOG(DEBUG, "Client Thread ACQUIRE EXCLUSIVE");
     #endif
@@ -461,8 +676,13 @@ namespace intercept {
 
     void invoker::unlock() {
         if (_main_thread) return;
-        --_thread_count;
+        const bool drained = --_thread_count == 0;
         _invoke_mutex.unlock();
+        if (drained) {
+            //Taking the state mutex makes sure the invoke period is either already waiting or will see the new count
+            { std::lock_guard<std::mutex> lock(_state_mutex); }
+            _invoke_drained.notify_one();
+        }
     #ifdef _DEBUG
         LOG(DEBUG, "Client Thread RELEASE EXCLUSIVE");
     #endif
@@ -10,12 +10,16 @@ https://github.com/NouberNou/intercept
 #include "shared.hpp"
 #include "singleton.hpp"
 #include "logging.hpp"
+#include "histogram.hpp"
 #include "arguments.hpp"
 #include "loader.hpp"
 #include "shared/types.hpp"
+#include "shared/functions.hpp"
 #include <mutex>
 #include <condition_variable>
 #include <queue>
+#include <chrono>
+#include <map>
 #include "eventhandlers.hpp"
 #include "sqf_functions.hpp"
 
@@ -101,6 +105,33 @@ namespace intercept {
         game_value invoke_raw(std::string_view function_name_, const game_value &left_, const game_value &right_) const;
         game_value invoke_raw(std::string_view function_name_, const game_value &left_, const std::string &left_type_, const game_value &right_, const std::string &right_type_) const;
         //!@}
+
+        /*!@{
+        @brief Asynchronous invoke functions.
+
+        Queue a SQF function call from any thread without taking the invoker lock.
+        Queued calls are executed in submission order by the main thread at the
+        start of the next invoke period, all in one batch.
+
+        Calls made from the main thread are executed immediately. Either way
+        callback_ is called on the main thread with user_data_ and the result.
+        Never block on the result from inside the invoke period or an `on_frame`
+        handler, the queue is only drained by the main thread.
+
+        @param module_id_ Id of the plugin that callback_ belongs to, see complete_async_jobs.
+        */
+        void invoke_async(uint32_t module_id_, const nular_function function_, invoke_async_callback callback_, void *user_data_);
+        void invoke_async(uint32_t module_id_, const unary_function function_, game_value right_, invoke_async_callback callback_, void *user_data_);
+        void invoke_async(uint32_t module_id_, const binary_function function_, game_value left_, game_value right_, invoke_async_callback callback_, void *user_data_);
+        //!@}
+
+        /*!
+        @brief Executes the queued calls of one plugin right away. Main thread only.
+
+        Their callbacks point into the plugin, so this has to run before it is
+        unloaded. Calls of other plugins stay queued in their order.
+        */
+        void complete_async_jobs(uint32_t module_id_);
         //!@}
 
         /*!
@@ -159,15 +190,46 @@ namespace intercept {
         This is easily the most important function in the invoker as it is the 
         function that dictates when other threads can access the game engine.
 
+        Calls queued through intercept::invoker::invoke_async are executed first,
+        in one batch, before the window for locking client threads opens.
+
         This function is invoked from a per-frame handler in SQF, each frame this
         controller function is called and the Invoker will unlock all client threads
-        for 3ms of access to the RV Engine and then it will close. Before it closes
-        though it invokes the clients `on_frame()` function, which is a blocking
-        function call that each client plugin can define for guaranteed per-frame
-        execution.
+        for a wall-clock budget of access to the RV Engine and then it will close.
+        The budget scales with the number of client threads holding or waiting for
+        the lock and is capped by a fraction of the measured frame time, clamped to
+        the range set by intercept::invoker::set_invoke_budget. The window closes
+        as soon as no client thread holds or waits for the lock anymore.
+
+        Before it closes though it invokes the clients `on_frame()` function, which
+        is a blocking function call that each client plugin can define for guaranteed
+        per-frame execution.
         */
         bool do_invoke_period();
 
+        /*!
+        @brief Sets the minimum and maximum time the invoke period may keep the
+        RV Engine open for client threads.
+
+        @param min_ Lower bound of the budget, used when few threads are waiting.
+        @param max_ Upper bound of the budget, never exceeded regardless of demand.
+        */
+        void set_invoke_budget(std::chrono::microseconds min_, std::chrono::microseconds max_);
+
+        /*!
+        @brief Controller function for intercept::invoker::set_invoke_budget.
+
+        Takes the minimum and maximum budget in microseconds as arguments.
+        */
+        bool invoker_set_budget(const arguments & args_, std::string & result_);
+
+        /*!
+        @brief Returns the current telemetry percentiles as a SQF array of
+        `[name, count, p50, p99, max]` entries. Pass `reset` to clear the
+        histograms afterwards.
+        */
+        bool invoker_metrics(const arguments & args_, std::string & result_);
+
         /*!
         @brief Consume an event from the RV Engine and dispatches it.
         */
@@ -208,6 +270,13 @@ namespace intercept {
 
         void unlock();
 
+        /*!
+        @brief Returns a summary of all telemetry histograms.
+
+        @param reset_ Clears all histograms after reading them.
+        */
+        auto_array<invoker_metric> get_metrics(bool reset_);
+
         //static game_data_string_pool<> string_pool;
         static game_state* sqf_game_state;
 
@@ -224,6 +293,95 @@ namespace intercept {
         std::atomic<uint32_t> _thread_count;
         std::atomic<uint32_t> _thread_waiting_for_lock_count;
 
+        /*!
+        @brief A SQF call queued through intercept::invoker::invoke_async.
+        */
+        struct invoke_job {
+            enum class call_type {
+                nular,
+                unary,
+                binary
+            } type;
+            union {
+                nular_function nular;
+                unary_function unary;
+                binary_function binary;
+            } function;
+            game_value left;
+            game_value right;
+            invoke_async_callback callback;
+            void *user_data;
+            uint32_t module_id;
+            invoke_job *next{ nullptr };
+        };
+
+        /*!
+        @brief Pushes a job onto the invoke queue, or executes it right away on
+        the main thread.
+        */
+        void _enqueue(std::unique_ptr<invoke_job> job_);
+
+        /*!
+        @brief Executes all queued jobs in submission order. Main thread only.
+        */
+        void _drain_invoke_queue();
+
+        /*!
+        @brief Moves everything on the invoke queue to the end of _invoke_backlog, in submission order. Main thread only.
+        */
+        void _take_invoke_queue();
+
+        /*!
+        @brief Executes and frees a linked list of jobs, handing each result to its callback.
+        */
+        static void _invoke_queue_execute(invoke_job *job_);
+
+        /*!
+        @brief Head of the lock-free multi-producer invoke queue. Producers push
+        onto it, the main thread takes the whole list at once.
+        */
+        std::atomic<invoke_job *> _invoke_queue;
+
+        /*!
+        @brief Jobs taken off _invoke_queue but not executed yet, oldest first. Only touched by the main thread.
+        */
+        invoke_job *_invoke_backlog{ nullptr };
+
+        /*!
+        @brief Calculates how long the current invoke period may stay open.
+        */
+        std::chrono::microseconds _invoke_budget(std::chrono::steady_clock::time_point now_);
+
+        /*!@{
+        @brief Bounds and per-thread share of the invoke period budget.
+        */
+        std::chrono::microseconds _invoke_budget_min;
+        std::chrono::microseconds _invoke_budget_max;
+        std::chrono::microseconds _invoke_budget_per_thread;
+        //!@}
+
+        /*!@{
+        @brief Telemetry, see intercept::invoker::get_metrics.
+        */
+        histogram _lock_wait_metric;
+        histogram _window_used_metric;
+        histogram _window_utilization_metric;
+        std::map<std::string, histogram> _on_frame_metrics;
+        std::mutex _metrics_lock;
+        //!@}
+
+        /*!
+        @brief Returns the on_frame histogram of a module, creating it on first use.
+        */
+        histogram& _on_frame_metric(const std::string& module_name_);
+
+        /*!
+        @brief Smoothed wall time between two invoke periods, used to cap the
+        budget to a fraction of the frame.
+        */
+        std::chrono::microseconds _frame_time;
+        std::chrono::steady_clock::time_point _last_invoke_period;
+
         /*!
         @brief The interceptEvent SQF Function that's used to get events with arguments
         */
@@ -272,6 +430,7 @@ namespace intercept {
         std::recursive_mutex _invoke_mutex;
         std::mutex _state_mutex;
         std::condition_variable _invoke_condition;
+        std::condition_variable _invoke_drained;
         //!@}
 
         /*!
@@ -124,6 +124,14 @@ void sqf_functions::setDisabled() noexcept {
     _canRegister = false;
 }
 
+void sqf_functions::setEnabled() noexcept {
+    _canRegister = true;
+}
+
+bool sqf_functions::isEnabled() const noexcept {
+    return _canRegister;
+}
+
 intercept::types::registered_sqf_function intercept::sqf_functions::register_sqf_function(std::string_view name, std::string_view description, WrapperFunctionBinary function_, types::game_data_type return_arg_type, types::game_data_type left_arg_type, types::game_data_type right_arg_type) {
     //Core plugins can overwrite existing functions. Which is "safe". So they can pass along for now.
     if (!_canRegister && intercept::cert::current_security_class != cert::signing::security_class::core) throw std::logic_error("Can only register SQF Commands on preStart");
@@ -85,6 +85,9 @@ namespace intercept {
         ~sqf_functions();
         void initialize() noexcept;
         void setDisabled() noexcept;
+        ///Allows registering again after setDisabled, used while a plugin is hot reloaded
+        void setEnabled() noexcept;
+        bool isEnabled() const noexcept;
         using WrapperFunctionBinary = intercept::types::binary_function;
         using WrapperFunctionUnary = intercept::types::unary_function;
         using WrapperFunctionNular = intercept::types::nular_function;
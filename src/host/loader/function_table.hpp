@@ -0,0 +1,118 @@
+/*!
+@file
+@brief Flat lookup table for SQF functions keyed by name and argument types.
+
+https://github.com/NouberNou/intercept
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace intercept {
+    /*!
+    @brief Open addressing hash table from (name, left type, right type) to a function.
+
+    Built once after the game state was walked, afterwards lookups are a single
+    hash and usually one probe, without allocating. Keys are compared case
+    sensitive, the same as the loader's maps did.
+
+    The table doesn't own the strings, they have to outlive it. The loader uses
+    the names stored in the game state which live as long as the game does.
+
+    Unused types are passed as empty strings, so nular and untyped lookups use
+    the same table.
+    */
+    template <typename Function>
+    class function_table {
+    public:
+        /*!
+        @brief Adds a function, unless the key is already in the table.
+
+        Overloads are inserted in the engine's order, so the first one wins
+        just like the linear search through the overloads did.
+
+        @return false if the key already existed.
+        */
+        bool insert(std::string_view name_, std::string_view left_, std::string_view right_, Function function_) {
+            if ((_size + 1) * 2 > _slots.size()) _grow();
+            const auto hash = hash_key(name_, left_, right_);
+            for (size_t index = hash & _mask;; index = (index + 1) & _mask) {
+                auto &current = _slots[index];
+                if (!current.function) {
+                    current = {hash, name_, left_, right_, function_};
+                    ++_size;
+                    return true;
+                }
+                if (current.hash == hash && current.name == name_ && current.left == left_ && current.right == right_)
+                    return false;
+            }
+        }
+
+        /*!
+        @return The function or nullptr if no entry matches.
+        */
+        Function find(std::string_view name_, std::string_view left_ = {}, std::string_view right_ = {}) const noexcept {
+            if (_slots.empty()) return nullptr;
+            const auto hash = hash_key(name_, left_, right_);
+            for (size_t index = hash & _mask;; index = (index + 1) & _mask) {
+                auto &current = _slots[index];
+                if (!current.function) return nullptr;
+                if (current.hash == hash && current.name == name_ && current.left == left_ && current.right == right_)
+                    return current.function;
+            }
+        }
+
+        size_t size() const noexcept { return _size; }
+
+        void clear() noexcept {
+            _slots.clear();
+            _mask = 0;
+            _size = 0;
+        }
+
+    private:
+        struct slot {
+            uint64_t hash;
+            std::string_view name;
+            std::string_view left;
+            std::string_view right;
+            Function function;
+        };
+
+        static void hash_part(uint64_t &hash_, std::string_view part_) noexcept {
+            for (auto character : part_) {
+                hash_ ^= static_cast<uint8_t>(character);
+                hash_ *= 1099511628211ull;
+            }
+            //Separator, so ("ab", "c") and ("a", "bc") don't collide
+            hash_ ^= 0xFF;
+            hash_ *= 1099511628211ull;
+        }
+
+        static uint64_t hash_key(std::string_view name_, std::string_view left_, std::string_view right_) noexcept {
+            uint64_t hash = 14695981039346656037ull;
+            hash_part(hash, name_);
+            hash_part(hash, left_);
+            hash_part(hash, right_);
+            return hash;
+        }
+
+        void _grow() {
+            std::vector<slot> old_slots(_slots.empty() ? 64 : _slots.size() * 2, slot{});
+            old_slots.swap(_slots);
+            _mask = _slots.size() - 1;
+            for (auto &current : old_slots) {
+                if (!current.function) continue;
+                auto index = current.hash & _mask;
+                while (_slots[index].function) index = (index + 1) & _mask;
+                _slots[index] = current;
+            }
+        }
+
+        std::vector<slot> _slots;
+        size_t _mask{0};
+        size_t _size{0};
+    };
+}  // namespace intercept
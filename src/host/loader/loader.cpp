@@ -1,5 +1,7 @@
 #include "loader.hpp"
 #include "controller.hpp"
+#include "pattern_scanner.hpp"
+#include "offset_cache.hpp"
 #include <thread>
 #include <future>
 #ifdef __linux__
@@ -24,115 +26,87 @@ namespace intercept {
     }
 
     bool loader::get_function(std::string_view function_name_, unary_function & function_, std::string_view arg_signature_) {
-        auto it = _unary_operators.find(function_name_);
-        if (it != _unary_operators.end()) {
-            for (auto op : it->second) {
-                if (op.op->arg_type.type().count(arg_signature_)) {
-                    function_ = reinterpret_cast<unary_function>(op.op->procedure_addr);
-                    return true;
-                }
-            }
-            return false;
-        }
-        return false;
+        function_ = _unary_table.find(function_name_, {}, arg_signature_);
+        return function_ != nullptr;
     }
 
     bool loader::get_function(std::string_view function_name_, unary_function & function_) {
-        auto it = _unary_operators.find(function_name_);
-        if (it != _unary_operators.end()) {
-            function_ = reinterpret_cast<unary_function>(it->second[0].op->procedure_addr);
-            return true;
-        }
-        return false;
+        function_ = _unary_table.find(function_name_);
+        return function_ != nullptr;
     }
 
     bool loader::get_function(std::string_view function_name_, binary_function & function_) {
-        auto it = _binary_operators.find(function_name_);
-        if (it != _binary_operators.end()) {
-            function_ = reinterpret_cast<binary_function>(it->second[0].op->procedure_addr);
-            return true;
-        }
-        return false;
+        function_ = _binary_table.find(function_name_);
+        return function_ != nullptr;
     }
 
     bool loader::get_function(std::string_view function_name_, binary_function & function_, std::string_view arg1_signature_, std::string_view arg2_signature_) {
-        auto it = _binary_operators.find(function_name_);
-        if (it != _binary_operators.end()) {
-            for (auto op : it->second) {
-                if (op.op->arg1_type.type().count(arg1_signature_) && op.op->arg2_type.type().count(arg2_signature_)) {
-                    function_ = reinterpret_cast<binary_function>(op.op->procedure_addr);
-                    return true;
-                }
-            }
-            return false;
-        }
-        return false;
+        function_ = _binary_table.find(function_name_, arg1_signature_, arg2_signature_);
+        return function_ != nullptr;
     }
 
     bool loader::get_function(std::string_view function_name_, nular_function & function_) {
-        auto it = _nular_operators.find(function_name_);
-        if (it != _nular_operators.end()) {
-            function_ = reinterpret_cast<nular_function>(it->second[0].op->procedure_addr);
-            return true;
+        function_ = _nular_table.find(function_name_);
+        return function_ != nullptr;
+    }
+
+    void loader::build_function_tables() {
+        //Type names point into the game state's type list, so they stay valid as long as the game runs
+        auto type_names = [](const sqf_script_type& type_) {
+            std::vector<std::string_view> names;
+            if (type_.single_type) {
+                names.emplace_back(type_.single_type->_name);
+            } else if (type_.compound_type) {
+                for (auto& it : *type_.compound_type)
+                    names.emplace_back(it->_name);
+            }
+            return names;
+        };
+
+        _unary_table.clear();
+        for (auto& [name, entries] : _unary_operators) {
+            //Untyped lookups return the first overload
+            _unary_table.insert(name, {}, {}, reinterpret_cast<unary_function>(entries.front().op->procedure_addr));
+            for (auto& entry : entries) {
+                for (auto& right : type_names(entry.op->arg_type))
+                    _unary_table.insert(name, {}, right, reinterpret_cast<unary_function>(entry.op->procedure_addr));
+            }
         }
-        return false;
+
+        _binary_table.clear();
+        for (auto& [name, entries] : _binary_operators) {
+            _binary_table.insert(name, {}, {}, reinterpret_cast<binary_function>(entries.front().op->procedure_addr));
+            for (auto& entry : entries) {
+                const auto right_types = type_names(entry.op->arg2_type);
+                for (auto& left : type_names(entry.op->arg1_type)) {
+                    for (auto& right : right_types)
+                        _binary_table.insert(name, left, right, reinterpret_cast<binary_function>(entry.op->procedure_addr));
+                }
+            }
+        }
+
+        _nular_table.clear();
+        for (auto& [name, entries] : _nular_operators)
+            _nular_table.insert(name, {}, {}, reinterpret_cast<nular_function>(entries.front().op->procedure_addr));
+
+        LOG(INFO, "Function tables: {} unary, {} binary, {} nular entries", _unary_table.size(), _binary_table.size(), _nular_table.size());
     }
 
     void loader::do_function_walk(uintptr_t state_addr_) {
         game_state_ptr = reinterpret_cast<game_state*>(state_addr_);
 
-    #ifdef __linux__
-        std::ifstream maps("/proc/self/maps");
-        uintptr_t start;
-        uintptr_t end;
-        char placeholder;
-        maps >> std::hex >> start >> placeholder >> end;
-        //link_map *lm = (link_map*) dlopen(0, RTLD_NOW);
-        //uintptr_t baseAddress = reinterpret_cast<uintptr_t>(lm->l_addr);
-        //uintptr_t moduleSize = 35000000; //35MB hardcoded till I find out how to detect it properly
-        uintptr_t baseAddress = start;
-        uintptr_t moduleSize = end - start;
-    #else
-        MODULEINFO modInfo = { nullptr };
-        HMODULE hModule = GetModuleHandleA(nullptr);
-        GetModuleInformation(GetCurrentProcess(), hModule, &modInfo, sizeof(MODULEINFO));
-        const uintptr_t baseAddress = reinterpret_cast<uintptr_t>(modInfo.lpBaseOfDll);
-        const uintptr_t moduleSize = static_cast<uintptr_t>(modInfo.SizeOfImage);
-    #endif
-        //std::cout << "base - size" << std::hex << baseAddress << moduleSize << "\n";
-        auto findInMemory = [baseAddress, moduleSize](const char* pattern, size_t patternLength) ->uintptr_t {
-            const uintptr_t base = baseAddress;
-            const uintptr_t size = moduleSize;
-            for (uintptr_t i = 0; i < size - patternLength; i++) {
-                bool found = true;
-                for (uintptr_t j = 0; j < patternLength; j++) {
-                    found &= pattern[j] == *reinterpret_cast<char*>(base + i + j);
-                    if (!found)
-                        break;
-                }
-                if (found)
-                    return base + i;
-            }
-            return 0;
-        };
+        //The searches below run concurrently, they share the scanner's helper threads instead of each starting their own
+        const memory::pattern_scanner scanner(memory::pattern_scanner::main_module_regions());
 
-        auto findInMemoryPattern = [baseAddress, moduleSize](const char* pattern, const char* mask, uintptr_t offset = 0) {
-            const uintptr_t base = baseAddress;
-            const uintptr_t size = moduleSize;
+        //Scan results are remembered across restarts, they are only valid for the same executable
+        memory::offset_cache offsetCache("intercept_offsets.cache", scanner);
 
-            const uintptr_t patternLength = static_cast<uintptr_t>(strlen(mask));
+        auto findInMemory = [&offsetCache](const char* pattern, size_t patternLength) -> uintptr_t {
+            return offsetCache.find(pattern, patternLength);
+        };
 
-            for (uintptr_t i = 0; i < size - patternLength; i++) {
-                bool found = true;
-                for (uintptr_t j = 0; j < patternLength; j++) {
-                    found &= mask[j] == '?' || pattern[j] == *reinterpret_cast<char*>(base + i + j);
-                    if (!found)
-                        break;
-                }
-                if (found)
-                    return base + i + offset;
-            }
-            return static_cast<uintptr_t>(0x0u);
+        auto findInMemoryPattern = [&offsetCache](const char* pattern, const char* mask, uintptr_t offset = 0) -> uintptr_t {
+            return offsetCache.find_pattern(pattern, mask, offset);
         };
 
         auto getRTTIName = [](uintptr_t vtable) -> const char* {
@@ -192,7 +166,8 @@ namespace intercept {
         auto future_allocatorVtablePtr = std::async(std::launch::deferred, [&]() {
             uintptr_t stringOffset = future_stringOffset.get();
         #ifndef __linux__
-            return (findInMemory(reinterpret_cast<char*>(&stringOffset), sizeof(uintptr_t)) - sizeof(uintptr_t));
+            //The pattern is a runtime address that changes with every start, caching it would only grow the cache file
+            return (scanner.find(reinterpret_cast<char*>(&stringOffset), sizeof(uintptr_t)) - sizeof(uintptr_t));
         #else
             uintptr_t vtableStart = stringOffset - (0x09D20C70 - 0x09D20BE8);
             return vtableStart;
@@ -350,6 +325,8 @@ namespace intercept {
             _nular_operators[entry._name2].push_back(new_entry);
         }
 
+        build_function_tables();
+
         //GameData pool allocators
         for (auto& entry : game_state_ptr->_scriptTypes) {
             if (!entry->_createFunction) continue; //Some types don't have create functions. Example: VECTOR.
@@ -421,10 +398,9 @@ namespace intercept {
 
     #endif
 
-
-
-
-
+        LOG(INFO, "Offset cache: {} hits, {} scans", offsetCache.hits(), offsetCache.misses());
+        if (!offsetCache.save())
+            LOG(WARNING, "Failed to write offset cache");
     }
 
     const unary_map & loader::unary() const {
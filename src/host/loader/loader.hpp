@@ -16,6 +16,7 @@ https://github.com/NouberNou/intercept
 #include "logging.hpp"
 #include "arguments.hpp"
 #include "shared/types.hpp"
+#include "function_table.hpp"
 #include <unordered_set>
 
 using namespace intercept::types;
@@ -206,6 +207,22 @@ namespace intercept {
         nular_map _nular_operators;
         //!@}
 
+        /*!
+        @name Function Lookup Tables
+        Flattened from the function maps once, every overload is listed under
+        each argument type it accepts. These answer get_function.
+        */
+        //!@{
+        function_table<unary_function> _unary_table;
+        function_table<binary_function> _binary_table;
+        function_table<nular_function> _nular_table;
+        //!@}
+
+        /*!
+        @brief Builds the lookup tables from the function maps.
+        */
+        void build_function_tables();
+
         /*!
         @brief Stores the hooked functions.
         */
@@ -0,0 +1,179 @@
+#include "offset_cache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <limits.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+namespace intercept::memory {
+    namespace {
+        constexpr uint32_t cache_magic = 0x434F4349;  //"ICOC"
+        constexpr uint32_t cache_version = 1;
+
+        struct cache_header {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t executable_key;
+            uint32_t entry_count;
+            uint32_t pointer_size;
+        };
+
+        struct cache_entry {
+            uint64_t pattern_hash;
+            uint64_t offset;
+        };
+
+        constexpr uint64_t fnv_offset_basis = 14695981039346656037ull;
+        constexpr uint64_t fnv_prime = 1099511628211ull;
+
+        uint64_t fnv1a(const void *data_, size_t length_, uint64_t hash_ = fnv_offset_basis) {
+            auto bytes = static_cast<const uint8_t *>(data_);
+            for (size_t i = 0; i < length_; ++i) {
+                hash_ ^= bytes[i];
+                hash_ *= fnv_prime;
+            }
+            return hash_;
+        }
+
+        uint64_t hash_pattern(const char *pattern_, size_t length_, const char *mask_) {
+            auto hash = fnv1a(&length_, sizeof(length_));
+            hash = fnv1a(pattern_, length_, hash);
+            //An unmasked search and a fully solid mask are different keys, that's fine
+            return mask_ ? fnv1a(mask_, length_, hash) : hash;
+        }
+    }  // namespace
+
+    offset_cache::offset_cache(std::string path_, const pattern_scanner &scanner_) : _path(std::move(path_)), _scanner(scanner_),
+        _module_base(scanner_.regions().empty() ? 0 : scanner_.regions().front().base), _executable_key(executable_key()) {
+        _load();
+    }
+
+    uintptr_t offset_cache::find(const char *pattern_, size_t length_) {
+        return _find(pattern_, length_, nullptr);
+    }
+
+    uintptr_t offset_cache::find_pattern(const char *pattern_, const char *mask_, uintptr_t offset_) {
+        const auto found = _find(pattern_, strlen(mask_), mask_);
+        return found ? found + offset_ : 0;
+    }
+
+    uintptr_t offset_cache::_find(const char *pattern_, size_t length_, const char *mask_) {
+        const auto key = hash_pattern(pattern_, length_, mask_);
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _used.insert(key);
+            auto it = _offsets.find(key);
+            if (it != _offsets.end()) {
+                //Nothing to validate for patterns that weren't found, the executable didn't change
+                if (it->second == not_found) {
+                    ++_hits;
+                    return 0;
+                }
+                const auto address = _module_base + static_cast<uintptr_t>(it->second);
+                if (_scanner.matches_at(address, pattern_, length_, mask_)) {
+                    ++_hits;
+                    return address;
+                }
+            }
+            ++_misses;
+        }
+
+        //Scan without holding the lock so parallel lookups don't wait for each other
+        const auto found = mask_ ? _scanner.find_pattern(pattern_, mask_) : _scanner.find(pattern_, length_);
+
+        std::lock_guard<std::mutex> lock(_lock);
+        _offsets[key] = found ? static_cast<uint64_t>(found - _module_base) : not_found;
+        _dirty = true;
+        return found;
+    }
+
+    void offset_cache::_load() {
+        if (!_executable_key) return;  //can't tell whether the cache belongs to this executable
+        std::ifstream file(_path, std::ios::binary);
+        if (!file) return;
+
+        cache_header header{};
+        if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))) return;
+        if (header.magic != cache_magic || header.version != cache_version || header.pointer_size != sizeof(uintptr_t) ||
+            header.executable_key != _executable_key)
+            return;
+
+        std::vector<cache_entry> entries(header.entry_count);
+        if (!file.read(reinterpret_cast<char *>(entries.data()), entries.size() * sizeof(cache_entry))) return;
+
+        std::lock_guard<std::mutex> lock(_lock);
+        for (auto &entry : entries)
+            _offsets[entry.pattern_hash] = entry.offset;
+    }
+
+    bool offset_cache::save() {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (auto it = _offsets.begin(); it != _offsets.end();) {
+            if (_used.count(it->first)) {
+                ++it;
+                continue;
+            }
+            it = _offsets.erase(it);
+            _dirty = true;
+        }
+        if (!_dirty) return true;
+        if (!_executable_key) return false;
+
+        const cache_header header{cache_magic, cache_version, _executable_key, static_cast<uint32_t>(_offsets.size()), sizeof(uintptr_t)};
+        std::vector<cache_entry> entries;
+        entries.reserve(_offsets.size());
+        for (auto &[hash, offset] : _offsets)
+            entries.push_back({hash, offset});
+
+        //Write a temporary file first, a crash while writing must not leave a truncated cache
+        const auto temp_path = _path + ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file) return false;
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(cache_entry));
+            if (!file) return false;
+        }
+        std::remove(_path.c_str());
+        if (std::rename(temp_path.c_str(), _path.c_str()) != 0) return false;
+        _dirty = false;
+        return true;
+    }
+
+    uint32_t offset_cache::hits() const {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _hits;
+    }
+
+    uint32_t offset_cache::misses() const {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _misses;
+    }
+
+    uint64_t offset_cache::executable_key() {
+    #ifdef __linux__
+        char exe_path[PATH_MAX];
+        const auto exe_length = readlink("/proc/self/exe", exe_path, sizeof(exe_path) - 1);
+        if (exe_length <= 0) return 0;
+        exe_path[exe_length] = '\0';
+        struct stat info {};
+        if (stat(exe_path, &info) != 0) return 0;
+    #else
+        wchar_t exe_path[MAX_PATH];
+        if (!GetModuleFileNameW(nullptr, exe_path, MAX_PATH)) return 0;
+        struct _stat64 info {};
+        if (_wstat64(exe_path, &info) != 0) return 0;
+    #endif
+        const uint64_t size = static_cast<uint64_t>(info.st_size);
+        const uint64_t modified = static_cast<uint64_t>(info.st_mtime);
+        return fnv1a(&modified, sizeof(modified), fnv1a(&size, sizeof(size)));
+    }
+}  // namespace intercept::memory
@@ -0,0 +1,89 @@
+/*!
+@file
+@brief Persistent cache of addresses found by the loader's memory scans.
+
+https://github.com/NouberNou/intercept
+*/
+#pragma once
+#include "pattern_scanner.hpp"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace intercept::memory {
+    /*!
+    @brief Remembers pattern scan results across restarts.
+
+    Results are stored as offsets relative to the start of the game executable
+    in a small binary file. The file is keyed by the size and modification time
+    of the executable, so a game update invalidates it.
+
+    Every cached address is verified by comparing the pattern at that exact
+    address before it is used. A mismatch falls back to a full scan, so a stale
+    or corrupt cache only costs the time it would have taken without a cache.
+
+    All members are thread safe, scans are usually started in parallel.
+    */
+    class offset_cache {
+    public:
+        /*!
+        @param path_ The cache file, it is created on save() if it doesn't exist.
+        @param scanner_ Used for scans and to validate cached results, must outlive the cache.
+        */
+        offset_cache(std::string path_, const pattern_scanner &scanner_);
+
+        /*!
+        @brief Cached pattern_scanner::find.
+        */
+        uintptr_t find(const char *pattern_, size_t length_);
+
+        /*!
+        @brief Cached pattern_scanner::find_pattern.
+        */
+        uintptr_t find_pattern(const char *pattern_, const char *mask_, uintptr_t offset_ = 0);
+
+        /*!
+        @brief Writes the cache file if any result changed since it was loaded.
+
+        Only patterns that were looked up since the cache was loaded are kept,
+        entries the loader no longer asks for are dropped from the file.
+
+        @return false if the file couldn't be written.
+        */
+        bool save();
+
+        /*!@{
+        @brief Number of lookups answered from the cache and number of full scans.
+        */
+        uint32_t hits() const;
+        uint32_t misses() const;
+        //!@}
+
+        /*!
+        @brief Identifies the running game executable by its size and last write time.
+        */
+        static uint64_t executable_key();
+
+    private:
+        uintptr_t _find(const char *pattern_, size_t length_, const char *mask_);
+        void _load();
+
+        static constexpr uint64_t not_found = UINT64_MAX;
+
+        std::string _path;
+        const pattern_scanner &_scanner;
+        uintptr_t _module_base;
+        uint64_t _executable_key;
+
+        mutable std::mutex _lock;
+        //! Hash of pattern and mask to offset from _module_base, or not_found.
+        std::unordered_map<uint64_t, uint64_t> _offsets;
+        //! Keys looked up in this run, everything else is pruned on save().
+        std::unordered_set<uint64_t> _used;
+        bool _dirty{false};
+        uint32_t _hits{0};
+        uint32_t _misses{0};
+    };
+}  // namespace intercept::memory
@@ -0,0 +1,323 @@
+#include "pattern_scanner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#define INTERCEPT_SCANNER_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#ifdef __linux__
+#include <limits.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#include <Psapi.h>
+#endif
+
+#if defined(__GNUC__)
+#define SCANNER_TARGET(x) __attribute__((target(x)))
+#else
+#define SCANNER_TARGET(x)
+#endif
+
+namespace intercept::memory {
+    namespace {
+        //Every candidate chunk is at least this big, smaller ones are not worth a thread
+        constexpr uintptr_t min_chunk_size = 1024 * 1024;
+
+        //Helper threads left for all searches together, the calling thread of a search is not counted
+        std::atomic<uint32_t> free_helpers{std::max(1u, std::thread::hardware_concurrency()) - 1};
+
+        //Takes up to wanted_ helpers from the pool, returns how many were taken
+        uint32_t claim_helpers(uint32_t wanted_) {
+            auto available = free_helpers.load(std::memory_order_relaxed);
+            uint32_t claimed;
+            do {
+                claimed = std::min(available, wanted_);
+                if (claimed == 0) return 0;
+            } while (!free_helpers.compare_exchange_weak(available, available - claimed, std::memory_order_relaxed));
+            return claimed;
+        }
+
+        enum class simd_level {
+            none,
+            sse2,
+            avx2
+        };
+
+        simd_level detect_simd() {
+        #ifdef INTERCEPT_SCANNER_X86
+        #ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 0);
+            const int max_leaf = info[0];
+            __cpuid(info, 1);
+            const bool sse2 = (info[3] & (1 << 26)) != 0;
+            const bool os_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+            bool avx2 = false;
+            if (max_leaf >= 7) {
+                __cpuidex(info, 7, 0);
+                avx2 = os_avx && (info[1] & (1 << 5));
+            }
+        #else
+            __builtin_cpu_init();
+            const bool sse2 = __builtin_cpu_supports("sse2");
+            const bool avx2 = __builtin_cpu_supports("avx2");
+        #endif
+            if (avx2) return simd_level::avx2;
+            if (sse2) return simd_level::sse2;
+        #endif
+            return simd_level::none;
+        }
+
+        const simd_level cpu_simd_level = detect_simd();
+
+        inline uint32_t lowest_bit(uint32_t mask_) {
+        #ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask_);
+            return index;
+        #else
+            return static_cast<uint32_t>(__builtin_ctz(mask_));
+        #endif
+        }
+
+        /*!
+        @brief Rough commonness of a byte in x86 machine code and data, higher is more common.
+        */
+        uint32_t byte_frequency(uint8_t byte_) {
+            switch (byte_) {
+                case 0x00: return 10;
+                case 0xFF: return 7;
+                case 0x8B: case 0x48: case 0x89: case 0x24: case 0x44: case 0x4C:
+                case 0x85: case 0xC0: case 0x83: case 0xE8: case 0x74: case 0x75:
+                case 0x0F: case 0xCC: case 0x01: case 0x08: case 0x04: case 0x10:
+                    return 5;
+                default:
+                    return 1;
+            }
+        }
+
+        struct compiled_pattern {
+            const uint8_t *bytes;
+            const char *mask;
+            size_t length;
+            size_t first_anchor;
+            size_t second_anchor;
+
+            bool is_solid(size_t index_) const { return !mask || mask[index_] != '?'; }
+
+            bool matches(const uint8_t *at_) const {
+                for (size_t i = 0; i < length; ++i) {
+                    if (is_solid(i) && bytes[i] != at_[i]) return false;
+                }
+                return true;
+            }
+        };
+
+        bool compile(compiled_pattern &pattern_) {
+            //Two anchors filter a lot better than one. Take the two rarest solid bytes.
+            size_t best = SIZE_MAX, second = SIZE_MAX;
+            for (size_t i = 0; i < pattern_.length; ++i) {
+                if (!pattern_.is_solid(i)) continue;
+                if (best == SIZE_MAX || byte_frequency(pattern_.bytes[i]) < byte_frequency(pattern_.bytes[best])) {
+                    second = best;
+                    best = i;
+                } else if (second == SIZE_MAX || byte_frequency(pattern_.bytes[i]) < byte_frequency(pattern_.bytes[second])) {
+                    second = i;
+                }
+            }
+            if (best == SIZE_MAX) return false;
+            pattern_.first_anchor = best;
+            pattern_.second_anchor = second == SIZE_MAX ? best : second;
+            return true;
+        }
+
+        /*!
+        @brief Scans all start positions in [begin_, end_), returns nullptr if nothing was found.
+        */
+        const uint8_t *scan_scalar(const compiled_pattern &pattern_, const uint8_t *begin_, const uint8_t *end_) {
+            const uint8_t first = pattern_.bytes[pattern_.first_anchor];
+            const uint8_t second = pattern_.bytes[pattern_.second_anchor];
+            for (auto it = begin_; it < end_; ++it) {
+                if (it[pattern_.first_anchor] == first && it[pattern_.second_anchor] == second && pattern_.matches(it))
+                    return it;
+            }
+            return nullptr;
+        }
+
+    #ifdef INTERCEPT_SCANNER_X86
+        SCANNER_TARGET("sse2")
+        const uint8_t *scan_sse2(const compiled_pattern &pattern_, const uint8_t *begin_, const uint8_t *end_) {
+            const __m128i first = _mm_set1_epi8(static_cast<char>(pattern_.bytes[pattern_.first_anchor]));
+            const __m128i second = _mm_set1_epi8(static_cast<char>(pattern_.bytes[pattern_.second_anchor]));
+            auto it = begin_;
+            for (; it + 16 <= end_; it += 16) {
+                const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(it + pattern_.first_anchor));
+                const __m128i block_second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(it + pattern_.second_anchor));
+                uint32_t candidates = static_cast<uint32_t>(_mm_movemask_epi8(
+                    _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_second, second))));
+                while (candidates) {
+                    const auto candidate = it + lowest_bit(candidates);
+                    if (pattern_.matches(candidate)) return candidate;
+                    candidates &= candidates - 1;
+                }
+            }
+            return scan_scalar(pattern_, it, end_);
+        }
+
+        SCANNER_TARGET("avx2")
+        const uint8_t *scan_avx2(const compiled_pattern &pattern_, const uint8_t *begin_, const uint8_t *end_) {
+            const __m256i first = _mm256_set1_epi8(static_cast<char>(pattern_.bytes[pattern_.first_anchor]));
+            const __m256i second = _mm256_set1_epi8(static_cast<char>(pattern_.bytes[pattern_.second_anchor]));
+            auto it = begin_;
+            for (; it + 32 <= end_; it += 32) {
+                const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(it + pattern_.first_anchor));
+                const __m256i block_second = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(it + pattern_.second_anchor));
+                uint32_t candidates = static_cast<uint32_t>(_mm256_movemask_epi8(
+                    _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_second, second))));
+                while (candidates) {
+                    const auto candidate = it + lowest_bit(candidates);
+                    if (pattern_.matches(candidate)) return candidate;
+                    candidates &= candidates - 1;
+                }
+            }
+            return scan_scalar(pattern_, it, end_);
+        }
+    #endif
+
+        const uint8_t *scan(const compiled_pattern &pattern_, const uint8_t *begin_, const uint8_t *end_) {
+        #ifdef INTERCEPT_SCANNER_X86
+            switch (cpu_simd_level) {
+                case simd_level::avx2: return scan_avx2(pattern_, begin_, end_);
+                case simd_level::sse2: return scan_sse2(pattern_, begin_, end_);
+                default: break;
+            }
+        #endif
+            return scan_scalar(pattern_, begin_, end_);
+        }
+
+        struct chunk {
+            uintptr_t begin;  //first start position
+            uintptr_t end;    //one past the last start position
+        };
+    }  // namespace
+
+    pattern_scanner::pattern_scanner(std::vector<region> regions_, uint32_t thread_count_) : _regions(std::move(regions_)), _thread_count(thread_count_) {
+        std::sort(_regions.begin(), _regions.end(), [](const region &left_, const region &right_) { return left_.base < right_.base; });
+        if (_thread_count == 0) _thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    uintptr_t pattern_scanner::find(const char *pattern_, size_t length_) const {
+        return _find(reinterpret_cast<const uint8_t *>(pattern_), nullptr, length_);
+    }
+
+    uintptr_t pattern_scanner::find_pattern(const char *pattern_, const char *mask_, uintptr_t offset_) const {
+        const auto found = _find(reinterpret_cast<const uint8_t *>(pattern_), mask_, strlen(mask_));
+        return found ? found + offset_ : 0;
+    }
+
+    bool pattern_scanner::matches_at(uintptr_t address_, const char *pattern_, size_t length_, const char *mask_) const {
+        for (auto &region : _regions) {
+            if (region.size < length_ || address_ < region.base || address_ - region.base > region.size - length_) continue;
+            const compiled_pattern pattern{reinterpret_cast<const uint8_t *>(pattern_), mask_, length_, 0, 0};
+            return pattern.matches(reinterpret_cast<const uint8_t *>(address_));
+        }
+        return false;
+    }
+
+    uintptr_t pattern_scanner::_find(const uint8_t *pattern_, const char *mask_, size_t length_) const {
+        if (length_ == 0 || _regions.empty()) return 0;
+
+        compiled_pattern pattern{pattern_, mask_, length_, 0, 0};
+        if (!compile(pattern)) return _regions.front().base;  //only wildcards, matches anywhere
+
+        //Split all start positions into chunks, in ascending address order
+        std::vector<chunk> chunks;
+        for (auto &region : _regions) {
+            if (region.size < length_) continue;
+            const uintptr_t last_start = region.base + region.size - length_ + 1;
+            const uintptr_t chunk_size = std::max(min_chunk_size, (last_start - region.base) / _thread_count + 1);
+            for (uintptr_t begin = region.base; begin < last_start; begin += chunk_size)
+                chunks.push_back({begin, std::min(begin + chunk_size, last_start)});
+        }
+        if (chunks.empty()) return 0;
+
+        std::atomic<uintptr_t> best{UINTPTR_MAX};
+        std::atomic<size_t> next_chunk{0};
+        auto worker = [&]() {
+            for (size_t index = next_chunk++; index < chunks.size(); index = next_chunk++) {
+                const auto &current = chunks[index];
+                //Chunks are handed out in order, once a lower match exists nothing after it can win
+                if (current.begin > best.load(std::memory_order_relaxed)) return;
+                const auto found = scan(pattern, reinterpret_cast<const uint8_t *>(current.begin), reinterpret_cast<const uint8_t *>(current.end));
+                if (!found) continue;
+                auto address = reinterpret_cast<uintptr_t>(found);
+                auto previous = best.load(std::memory_order_relaxed);
+                while (address < previous && !best.compare_exchange_weak(previous, address, std::memory_order_relaxed)) {}
+                return;
+            }
+        };
+
+        //Chunks are pulled from next_chunk, so the search is complete with however many helpers were free
+        const auto helpers = claim_helpers(static_cast<uint32_t>(std::min<size_t>(_thread_count, chunks.size()) - 1));
+        std::vector<std::thread> threads;
+        threads.reserve(helpers);
+        for (uint32_t i = 0; i < helpers; ++i)
+            threads.emplace_back(worker);
+        worker();
+        for (auto &thread : threads)
+            thread.join();
+        free_helpers.fetch_add(helpers, std::memory_order_relaxed);
+
+        const auto found = best.load();
+        return found == UINTPTR_MAX ? 0 : found;
+    }
+
+    std::vector<region> pattern_scanner::main_module_regions() {
+        std::vector<region> regions;
+    #ifdef __linux__
+        char exe_path[PATH_MAX];
+        const auto exe_length = readlink("/proc/self/exe", exe_path, sizeof(exe_path) - 1);
+        const std::string executable = exe_length > 0 ? std::string(exe_path, exe_length) : std::string();
+
+        std::ifstream maps("/proc/self/maps");
+        std::string line;
+        region first_mapping{};
+        while (std::getline(maps, line)) {
+            //address           perms offset  dev   inode   pathname
+            //08048000-08056000 r-xp 00000000 03:0c 64593   /usr/sbin/gpm
+            std::istringstream fields(line);
+            uintptr_t start, end;
+            char separator;
+            std::string perms, offset, device, inode, path;
+            fields >> std::hex >> start >> separator >> end >> perms >> offset >> device >> inode;
+            std::getline(fields >> std::ws, path);
+            if (!first_mapping.size) first_mapping = {start, end - start};
+
+            if (path != executable || perms.empty() || perms[0] != 'r') continue;
+            if (!regions.empty() && regions.back().base + regions.back().size == start)
+                regions.back().size += end - start;
+            else
+                regions.push_back({start, end - start});
+        }
+        //Couldn't identify the executable, fall back to the first mapping which usually is the executable
+        if (regions.empty() && first_mapping.size) regions.push_back(first_mapping);
+    #else
+        MODULEINFO modInfo = {nullptr};
+        HMODULE hModule = GetModuleHandleA(nullptr);
+        GetModuleInformation(GetCurrentProcess(), hModule, &modInfo, sizeof(MODULEINFO));
+        regions.push_back({reinterpret_cast<uintptr_t>(modInfo.lpBaseOfDll), static_cast<uintptr_t>(modInfo.SizeOfImage)});
+    #endif
+        return regions;
+    }
+}  // namespace intercept::memory
@@ -0,0 +1,89 @@
+/*!
+@file
+@brief Signature scanner used by the loader to find engine functions.
+
+https://github.com/NouberNou/intercept
+*/
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace intercept::memory {
+    /*!
+    @brief A readable, contiguous range of memory.
+    */
+    struct region {
+        uintptr_t base;
+        uintptr_t size;
+    };
+
+    /*!
+    @brief Searches memory regions for byte patterns.
+
+    Candidates are filtered 16 or 32 bytes at a time by comparing two anchor
+    bytes of the pattern (the rarest ones in x86 code) with SSE2 or AVX2,
+    depending on what the CPU supports. Only positions where both anchors match
+    are compared in full. The regions are split into chunks which are scanned
+    by multiple threads, the lowest matching address always wins.
+
+    All searches in the process share one pool of helper threads, one less
+    than there are hardware threads. A search that runs while others already
+    use the pool gets fewer or no helpers and scans on its calling thread, so
+    the loader can run many searches concurrently without oversubscribing.
+    */
+    class pattern_scanner {
+    public:
+        /*!
+        @param regions_ The memory to search, in ascending address order.
+        @param thread_count_ Most threads one search uses, 0 uses one per hardware thread.
+        Helpers are only started while the shared pool has some left.
+        */
+        explicit pattern_scanner(std::vector<region> regions_, uint32_t thread_count_ = 0);
+
+        /*!
+        @brief Finds the first occurrence of an exact byte sequence.
+
+        @return The address of the match, 0 if not found.
+        */
+        uintptr_t find(const char *pattern_, size_t length_) const;
+
+        /*!
+        @brief Finds the first occurrence of a masked byte pattern.
+
+        @param pattern_ The bytes to search for.
+        @param mask_ A string of the same length as the pattern, `?` marks a
+        wildcard byte, anything else must match.
+        @param offset_ Added to the returned address on a match.
+
+        @return The address of the match plus offset_, 0 if not found.
+        */
+        uintptr_t find_pattern(const char *pattern_, const char *mask_, uintptr_t offset_ = 0) const;
+
+        /*!
+        @brief Checks whether a pattern matches at exactly the given address.
+
+        Used to validate addresses that were found by an earlier scan.
+
+        @param mask_ Same format as in find_pattern, nullptr compares all bytes.
+        */
+        bool matches_at(uintptr_t address_, const char *pattern_, size_t length_, const char *mask_ = nullptr) const;
+
+        const std::vector<region> &regions() const noexcept { return _regions; }
+
+        /*!
+        @brief Returns the memory of the game executable.
+
+        On Windows this is the image of the main module. On Linux these are all
+        readable mappings of the executable file from `/proc/self/maps`, merged
+        where they are contiguous, so code and read-only data are both covered.
+        */
+        static std::vector<region> main_module_regions();
+
+    private:
+        uintptr_t _find(const uint8_t *pattern_, const char *mask_, size_t length_) const;
+
+        std::vector<region> _regions;
+        uint32_t _thread_count;
+    };
+}  // namespace intercept::memory